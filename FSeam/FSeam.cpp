@@ -0,0 +1,8 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+// Non-template part of FSeam compiled once into the FSeam-static library
+
+#include "FSeam.hpp"
+#include "FSeamImpl.hpp"
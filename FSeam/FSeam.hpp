@@ -34,12 +34,34 @@
 
 #include <utility>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
-#include <iostream>
 #include <variant>
 #include <map>
 #include <any>
+#include <cstddef>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <optional>
+#include <vector>
+
+/**
+ * The non-template part of FSeam (FSeamImpl.hpp) is compiled once into the FSeam-static library, defining
+ * FSEAM_HEADER_ONLY (set by the FSeam target) includes it into each translation unit instead.
+ */
+#ifdef FSEAM_HEADER_ONLY
+#define FSEAM_INLINE inline
+#else
+#define FSEAM_INLINE
+#endif
 
 namespace FSeam {
 
@@ -51,7 +73,7 @@ namespace FSeam {
      */
     template <typename T>
     struct TypeParseTraits {
-        inline static const std::string ClassName = "FreeFunction";
+        static constexpr std::string_view ClassName = "FreeFunction";
     };
 
     /**
@@ -101,6 +123,33 @@ namespace FSeam {
     template <> struct isCalledComparator<NeverCalled> { static const bool v = true; };
     template <> struct isCalledComparator<VerifyCompare> { static const bool v = true; };
 
+    /**
+     * @brief List of the calling comparators (void for none) for which the expectArg of a method has a generated
+     *        specialization, set on each method identifier (Specializations), other comparators use the generic expectArg
+     */
+    template <typename ...Comparators>
+    struct SpecializedExpectations {
+        template <typename Comparator>
+        static constexpr bool contains = (std::is_same_v<Comparator, Comparators> || ...);
+    };
+
+    namespace internal {
+        template <typename ...Verifiers>
+        struct CalledComparatorOf { using type = void; };
+        template <typename Verifier>
+        struct CalledComparatorOf<Verifier> {
+            using type = std::conditional_t<isCalledComparator<Verifier>::v, Verifier, void>;
+        };
+        template <typename Verifier, typename ...Verifiers>
+        struct CalledComparatorOf<Verifier, Verifiers...> : CalledComparatorOf<Verifiers...> {};
+
+        // deferred expectations compare the values copied in the columns (no reference_wrapper on them)
+        template <typename CompareType>
+        struct DeferredCompare { using type = CompareType; };
+        template <typename T>
+        struct DeferredCompare<std::reference_wrapper<T>> { using type = const T &; };
+    }
+
     /**
      * @brief Comparators option used in verify in order to give more flexibility into the check possible via te verify option
      * @note To be used in order to check the arguments of a method via the MockClassVerifier::verifyArg method
@@ -213,19 +262,12 @@ namespace FSeam {
             inline static bool customEnabled = false;
 
             static std::function<void(Level, const std::string &)> &custom(
-                    std::optional<std::function<void(Level, const std::string &)> > logging = std::nullopt) {
-
-                static std::function<void(Level, const std::string &)> customLogger =
-                        logging.value_or([](Level l, const std::string &msg) {
+                    std::optional<std::function<void(Level, const std::string &)> > logging = std::nullopt);
 
-                    if (l == Level::ERROR)
-                        std::cerr << msg << "\n";
-                    else
-                        std::cout << msg << "\n";
-                });
-                customEnabled = true;
-                return customLogger;
-            }
+            /**
+             * @brief Default logging, errors on the standard error output, others on the standard output
+             */
+            static void print(Level level, const std::string &msg);
 
             static void log(Level level, const std::string &msg) {
                 if (!customEnabled) {
@@ -236,10 +278,7 @@ namespace FSeam {
                     else
                         WARN(msg);
                     #elif FSEAM_USE_GTEST
-                    if (level == Level::ERROR)
-                        std::cerr << msg << "\n";
-                    else
-                        std::cout << msg << "\n";
+                    print(level, msg);
                     #else
                     custom()(level, msg);
                     #endif
@@ -251,12 +290,562 @@ namespace FSeam {
         };
     }
 
+    namespace internal {
+        template <typename T> struct isDuration : std::false_type {};
+        template <typename Rep, typename Period> struct isDuration<std::chrono::duration<Rep, Period> > : std::true_type {};
+
+        template <typename T> struct isTimePoint : std::false_type {};
+        template <typename Clock, typename Duration> struct isTimePoint<std::chrono::time_point<Clock, Duration> > : std::true_type {};
+
+        /**
+         * @brief Get the value captured in a method call data structure (reference argument are stored as std::reference_wrapper)
+         */
+        template <typename T> const T &unwrap(const T &value) { return value; }
+        template <typename T> T &unwrap(std::reference_wrapper<T> value) { return value.get(); }
+    }
+
+#ifndef FSEAM_CAPTURE_ARENA_THRESHOLD
+#define FSEAM_CAPTURE_ARENA_THRESHOLD 256
+#endif
+
+    /**
+     * @brief Bump allocator in which the large trivially copyable arguments of the mocked calls are captured
+     * @details Memory is allocated by blocks and is only released when the FSeam context is cleaned up
+     *          (MockVerifier::cleanUp), the captured arguments are then valid for the whole test.
+     *          MockVerifier::reset rewinds the arena instead: the blocks are kept and reused from the first one.
+     */
+    class CaptureArena {
+        static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+    public:
+        static void *allocate(std::size_t size);
+
+        static void reset();
+
+        /**
+         * @brief Reuse the allocated blocks from the beginning, the arguments captured before are overwritten
+         */
+        static void rewind();
+
+    private:
+        // blocks and their size
+        static std::vector<std::pair<std::unique_ptr<std::max_align_t[]>, std::size_t>> _blocks;
+        static std::size_t _current;
+        static std::size_t _used;
+    };
+
+    /**
+     * @brief Define how an argument passed by value to a mocked method is captured in the method call data structure
+     *        - copyable arguments are copied
+     *        - move-only / non-copyable arguments are borrowed (reference on the argument, valid during the call)
+     *        - large trivially copyable arguments (bigger than FSEAM_CAPTURE_ARENA_THRESHOLD) are copied into the
+     *          CaptureArena, the data structure only keeps a reference on it
+     *        Borrowed and arena captured arguments are compared as const reference (CustomComparator<const T &>).
+     */
+    template <typename T>
+    struct CaptureTraits {
+        using value_type = std::decay_t<T>;
+
+        static constexpr bool inArena = std::is_trivially_copyable_v<value_type> &&
+                sizeof(value_type) > FSEAM_CAPTURE_ARENA_THRESHOLD && alignof(value_type) <= alignof(std::max_align_t);
+        static constexpr bool copied = std::is_copy_constructible_v<value_type> && !inArena;
+
+        using type = std::conditional_t<copied, value_type, std::reference_wrapper<const value_type>>;
+        using compare_type = std::conditional_t<copied, value_type, const value_type &>;
+    };
+
+    template <typename T> using Capture = typename CaptureTraits<T>::type;
+    template <typename T> using CaptureCompare = typename CaptureTraits<T>::compare_type;
+
+    /**
+     * @note This method should never be used by the client directly, it is a "FSeam generated" method only
+     */
+    template <typename T>
+    Capture<T> capture(const std::decay_t<T> &value) {
+        using Traits = CaptureTraits<T>;
+
+        if constexpr (Traits::inArena) {
+            void *memory = CaptureArena::allocate(sizeof(typename Traits::value_type));
+            std::memcpy(memory, &value, sizeof(typename Traits::value_type));
+            return std::cref(*static_cast<const typename Traits::value_type *>(memory));
+        }
+        else if constexpr (Traits::copied)
+            return value;
+        else
+            return std::cref(value);
+    }
+
+    /**
+     * @brief Virtual clock used to replace the time in the tested code (see MockClassVerifier::dupeVirtualClock) and by the
+     *        latency/throttling dupes in order to simulate the time spent into a mocked call
+     * @details By default the clock is virtual: sleeping on it just moves the current time forward without blocking
+     *          the calling thread. This makes timeout and backpressure paths testable without slowing down the test suite.
+     *          Real sleeps can be restored by calling VirtualClock::useRealTime(true).
+     *          The clock fulfill the std::chrono Clock requirements, its epoch is the origin (0 by default, see setOrigin)
+     */
+    class VirtualClock {
+    public:
+        using rep = std::int64_t;
+        using period = std::nano;
+        using duration = std::chrono::duration<rep, period>;
+        using time_point = std::chrono::time_point<VirtualClock>;
+        static constexpr bool is_steady = true;
+
+        /**
+         * @return current time of the virtual clock (origin + elapsed)
+         */
+        static time_point now() noexcept { return time_point(duration(_origin.load() + _elapsed.load())); }
+
+        /**
+         * @return time elapsed on the virtual clock since the last reset
+         */
+        static duration elapsed() { return duration(_elapsed.load()); }
+
+        /**
+         * @brief set the time since epoch returned by now() when no time has elapsed, can be used to start the virtual clock
+         *        at a realistic time (std::chrono::system_clock::now().time_since_epoch() for instance)
+         */
+        static void setOrigin(duration origin) { _origin = origin.count(); }
+
+        /**
+         * @brief move the virtual clock forward of the given duration
+         */
+        static void advance(duration d) { _elapsed += d.count(); }
+
+        /**
+         * @brief sleep for the given duration, the virtual clock is always moved forward. The calling thread is actually
+         *        blocked only if the clock is set to use the real time.
+         */
+        static void sleepFor(duration d);
+
+        static void useRealTime(bool realTime) { _realTime = realTime; }
+
+        /**
+         * @brief Reset the clock at its origin and set it back as virtual, called by MockVerifier::cleanUp
+         */
+        static void reset() {
+            _origin = 0;
+            _elapsed = 0;
+            _realTime = false;
+        }
+
+        /**
+         * @brief Move the clock back to its origin (keeping the origin and the real time setting), called by MockVerifier::reset
+         */
+        static void rewind() { _elapsed = 0; }
+
+        /**
+         * @brief Convert the current virtual time into the type T
+         * @tparam T either a std::chrono::time_point (of any clock, the virtual time being taken as time since its epoch),
+         *         a std::chrono::duration (time since epoch), or an arithmetic type (count of Unit since epoch)
+         * @tparam Unit unit used when T is an arithmetic type
+         */
+        template <typename T, typename Unit = std::chrono::nanoseconds>
+        static T as() {
+            if constexpr (internal::isTimePoint<T>::value)
+                return T(std::chrono::duration_cast<typename T::duration>(now().time_since_epoch()));
+            else if constexpr (internal::isDuration<T>::value)
+                return std::chrono::duration_cast<T>(now().time_since_epoch());
+            else {
+                static_assert(std::is_arithmetic<T>(), "Virtual time can only be converted into time_point, duration or arithmetic type");
+                return static_cast<T>(std::chrono::duration_cast<Unit>(now().time_since_epoch()).count());
+            }
+        }
+
+        /**
+         * @brief Convert a duration (or an arithmetic count of Unit) into a VirtualClock::duration
+         */
+        template <typename Unit = std::chrono::nanoseconds, typename T>
+        static duration toDuration(const T &value) {
+            if constexpr (internal::isDuration<T>::value)
+                return std::chrono::duration_cast<duration>(value);
+            else {
+                static_assert(std::is_arithmetic<T>(), "Only duration or arithmetic type can be converted into a virtual duration");
+                return std::chrono::duration_cast<duration>(Unit(static_cast<typename Unit::rep>(value)));
+            }
+        }
+
+    private:
+        inline static std::atomic<rep> _origin = 0;
+        inline static std::atomic<rep> _elapsed = 0;
+        inline static std::atomic<bool> _realTime = false;
+    };
+
+    /**
+     * @brief Test controlled executor of the asynchronous results and asynchronous return type traits used by
+     *        MockClassVerifier::dupeAsyncReturn (see FSeamAsync.hpp)
+     */
+    class AsyncExecutor;
+    template <typename Awaitable>
+    struct AsyncReturn;
+
+    /**
+     * @brief Token bucket used by MockClassVerifier::dupeRateLimit (see FSeamLatency.hpp)
+     */
+    namespace Latency {
+        struct TokenBucket;
+    }
+
+    /**
+     * @brief Hook called at the beginning of each mocked call (before its dupe), the mocked calls are then the schedule
+     *        points of the threads controlled by the interleaving explorer (see FSeamSchedule.hpp)
+     */
+    struct SchedulePoint {
+        inline static std::atomic<void (*)()> hook = nullptr;
+
+        /**
+         * @brief Call the hook if an explorer is running, the caller must not hold a lock another controlled thread may
+         *        wait for (the calling thread can be suspended here)
+         */
+        static void reach() {
+            if (auto schedule = hook.load(std::memory_order_acquire); schedule)
+                schedule();
+        }
+    };
+
+    /**
+     * @brief Call of a mocked method recorded in the shared registry (see MockClassVerifier::sharedCalls)
+     */
+    struct SharedCall {
+        std::int64_t pid;
+        // VirtualClock::elapsed() at the time of the call in the calling process
+        VirtualClock::duration elapsed;
+        // order of the call among all the calls recorded
+        std::uint64_t sequence;
+    };
+
+    /**
+     * @brief Call counters and call records of the mocks in a shared memory segment (MockVerifier::shareAcrossProcesses)
+     * @details The segment is an anonymous shared mapping: the processes forked after its creation increment the same
+     *          counters, verify then aggregates the calls made by all the processes. The counter of a method is found
+     *          once per method and process (open addressing on the identifier of the mock and the name of the method,
+     *          lock-free insertion) and cached in its MethodCallVerifier. A call costs an atomic increment and the append
+     *          into a ring buffer of call records (the oldest records are overwritten), no system call.
+     */
+    class SharedRegistry {
+    public:
+        struct Slot {
+            std::atomic<std::uint64_t> key;
+            std::atomic<std::uint64_t> count;
+        };
+
+        static bool create(std::size_t slots, std::size_t records);
+
+        static void release();
+
+        static bool active() { return _segment != nullptr; }
+
+        /**
+         * @brief incremented at each creation, a cached slot is valid for the generation it has been looked up in
+         */
+        static std::uint64_t generation() { return _generation; }
+
+        /**
+         * @brief true once an insertion failed because all the slots are taken (by any of the processes)
+         */
+        static bool full() { return _segment && _segment->full.load(std::memory_order_acquire); }
+
+        /**
+         * @param inserted set to true if the slot has been inserted by this call
+         * @return counter of the given key (see key()), inserted if insert is true, nullptr if not found or the table is full
+         */
+        static Slot *slot(std::uint64_t key, bool insert, bool *inserted = nullptr);
+
+        static void record(std::uint64_t key);
+
+        static std::vector<SharedCall> records(std::uint64_t key);
+
+        /**
+         * @brief The records appended before are not returned by records() anymore (MockVerifier::reset)
+         */
+        static void clearRecords();
+
+        static std::uint64_t key(std::uint64_t mockId, std::string_view methodName) {
+            std::uint64_t hash = mockId ^ 14695981039346656037ull;
+            for (char c : methodName)
+                hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+            return hash ? hash : 1;
+        }
+
+        static std::uint64_t mockId(std::string_view className, const void *mockPtr = nullptr) {
+            return key(reinterpret_cast<std::uintptr_t>(mockPtr), className);
+        }
+
+    private:
+        struct Record {
+            std::atomic<std::uint64_t> key;
+            std::atomic<std::int64_t> pid;
+            std::atomic<VirtualClock::rep> elapsed;
+            // index + 1 once written
+            std::atomic<std::uint64_t> sequence;
+        };
+
+        struct Segment {
+            std::size_t size;
+            std::size_t slotCount;
+            std::size_t recordCount;
+            std::atomic<std::uint64_t> head;
+            std::atomic<std::uint64_t> floor;
+            std::atomic<bool> full;
+        };
+
+        static Slot *slots() { return reinterpret_cast<Slot *>(_segment + 1); }
+        static Record *ring() { return reinterpret_cast<Record *>(slots() + _segment->slotCount); }
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "the shared registry requires lock-free 64 bits atomics");
+
+        inline static Segment *_segment = nullptr;
+        inline static std::uint64_t _generation = 0;
+        // getpid is a system call (not cached by the libc), the pid is cached and updated in the forked process
+        inline static std::atomic<std::int64_t> _pid = 0;
+    };
+
+    /**
+     * @brief Define how a value of type T is taken from the FSeam::FuzzInput (see MockClassVerifier::dupeFromFuzzInput)
+     * @details Trivially copyable types are copied from the bytes of the input, bool and std::string are specialized.
+     *          Specialize it (static T consume()) for the other return types duped from the fuzzer input.
+     *          Pointers (and member pointers) are rejected: random bytes aren't a valid address. The raw copy can give
+     *          a NaN floating point or an enum value out of its enumerators, specialize the type if the code under
+     *          test doesn't expect those.
+     */
+    template <typename T, typename = void>
+    struct FuzzTraits;
+
+    /**
+     * @brief Input of the current fuzzing iteration (the data given to LLVMFuzzerTestOneInput), consumed in order by the
+     *        mocked methods duped with MockClassVerifier::dupeFromFuzzInput
+     * @details Once the input is exhausted, the missing bytes are zero: a same input always replays the same values.
+     */
+    class FuzzInput {
+    public:
+        /**
+         * @brief Set the input of the iteration, the data has to stay valid until the iteration is over (not copied)
+         */
+        static void set(const std::uint8_t *data, std::size_t size) {
+            _data = data;
+            _size = size;
+            _offset = 0;
+        }
+
+        static std::size_t remaining() { return _size - _offset; }
+
+        /**
+         * @brief Copy the next size bytes of the input into out (zero filled once the input is exhausted)
+         * @return number of bytes actually taken from the input
+         */
+        static std::size_t consumeBytes(void *out, std::size_t size) {
+            std::size_t taken = std::min(size, remaining());
+            if (taken)
+                std::memcpy(out, _data + _offset, taken);
+            std::memset(static_cast<std::uint8_t *>(out) + taken, 0, size - taken);
+            _offset += taken;
+            return taken;
+        }
+
+        template <typename T>
+        static T consume() { return FuzzTraits<T>::consume(); }
+
+    private:
+        inline static const std::uint8_t *_data = nullptr;
+        inline static std::size_t _size = 0;
+        inline static std::size_t _offset = 0;
+    };
+
+    template <typename T, typename>
+    struct FuzzTraits {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+                && !std::is_pointer_v<T> && !std::is_member_pointer_v<T>,
+                "The type can't be taken from the fuzzer input, FSeam::FuzzTraits has to be specialized for it");
+
+        static T consume() {
+            T value;
+            FuzzInput::consumeBytes(&value, sizeof(T));
+            return value;
+        }
+    };
+
+    template <>
+    struct FuzzTraits<bool> {
+        static bool consume() { return FuzzInput::consume<std::uint8_t>() & 1u; }
+    };
+
+    /**
+     * @brief A byte of length followed by the content of the string (truncated to the remaining input)
+     */
+    template <>
+    struct FuzzTraits<std::string> {
+        static std::string consume() {
+            std::size_t length = FuzzInput::consume<std::uint8_t>();
+            std::string value(std::min(length, FuzzInput::remaining()), '\0');
+            FuzzInput::consumeBytes(value.data(), value.size());
+            return value;
+        }
+    };
+
     /**
      * @brief basic structure that contains description and usage metadata of a mocked method
      */
     template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
     template<class... Ts> overload(Ts...) -> overload<Ts...>;
 
+    namespace internal {
+
+        /**
+         * @brief Column of the captured values of an argument of a mocked method (deferred expectation mode)
+         * @details Scalar (arithmetic / enum) arguments are stored in a contiguous array next to a presence array (structure
+         *          of arrays) so that Eq / NotEq are evaluated with a branchless loop the compiler can vectorize. Other
+         *          arguments are stored as optional copies and compared one by one.
+         */
+        template <typename T, bool IsScalar = std::is_arithmetic_v<T> || std::is_enum_v<T>>
+        struct Column {
+            template <typename Arg>
+            void append(const std::optional<Arg> &arg) {
+                if constexpr (std::is_copy_constructible_v<T>) {
+                    if (arg) {
+                        _values.emplace_back(unwrap(*arg));
+                        return;
+                    }
+                }
+                _values.emplace_back(std::nullopt);
+            }
+
+            void clear() { _values.clear(); }
+
+            template <typename TypeToCompare>
+            void filter(const ArgComp &comp, std::size_t from, std::vector<std::uint8_t> &mask) const {
+                if (std::holds_alternative<comparator::internal::Any>(comp._comp))
+                    return;
+                for (std::size_t i = 0; i < mask.size(); ++i)
+                    mask[i] &= _values[from + i].has_value() && comp.compare<TypeToCompare>(*_values[from + i]);
+            }
+
+            std::vector<std::optional<T>> _values;
+        };
+
+        template <typename T>
+        struct Column<T, true> {
+            template <typename Arg>
+            void append(const std::optional<Arg> &arg) {
+                _values.emplace_back(arg ? unwrap(*arg) : T{});
+                _present.emplace_back(arg.has_value());
+            }
+
+            void clear() {
+                _values.clear();
+                _present.clear();
+            }
+
+            template <typename TypeToCompare>
+            void filter(const ArgComp &comp, std::size_t from, std::vector<std::uint8_t> &mask) const {
+                const T *values = _values.data() + from;
+                const std::uint8_t *present = _present.data() + from;
+                std::uint8_t *out = mask.data();
+                std::size_t size = mask.size();
+
+                if (std::holds_alternative<comparator::internal::Any>(comp._comp))
+                    return;
+                if (auto eq = std::get_if<comparator::internal::Eq>(&comp._comp)) {
+                    const T expected = std::any_cast<std::decay_t<TypeToCompare>>(*eq->_toCompare);
+                    for (std::size_t i = 0; i < size; ++i)
+                        out[i] &= present[i] & static_cast<std::uint8_t>(values[i] == expected);
+                }
+                else if (auto notEq = std::get_if<comparator::internal::NotEq>(&comp._comp)) {
+                    const T expected = std::any_cast<std::decay_t<TypeToCompare>>(*notEq->_toCompare);
+                    for (std::size_t i = 0; i < size; ++i)
+                        out[i] &= present[i] & static_cast<std::uint8_t>(values[i] != expected);
+                }
+                else {
+                    for (std::size_t i = 0; i < size; ++i)
+                        out[i] &= present[i] && comp.compare<TypeToCompare>(values[i]);
+                }
+            }
+
+            std::vector<T> _values;
+            std::vector<std::uint8_t> _present;
+        };
+
+        struct ColumnStoreBase {
+            virtual ~ColumnStoreBase() = default;
+            virtual void append(void *data) = 0;
+            virtual void clear() = 0;
+
+            // calls appended since the creation of the store, the _cleared first ones have been discarded (MockVerifier::reset)
+            std::size_t _size = 0;
+            std::size_t _cleared = 0;
+        };
+
+        /**
+         * @brief Columns (one per argument) of all the calls of a mocked method made since the first deferred expectation
+         *        has been registered on it
+         */
+        template <typename ClassMethodIdentifier, typename Args = decltype(ClassMethodIdentifier::args(nullptr))>
+        struct ColumnStore;
+
+        template <typename ClassMethodIdentifier, typename ...Ts>
+        struct ColumnStore<ClassMethodIdentifier, std::tuple<std::optional<Ts>&...>> : ColumnStoreBase {
+            void append(void *data) override {
+                std::apply([this](const auto &...args) { appendColumns(std::index_sequence_for<Ts...>(), args...); },
+                           ClassMethodIdentifier::args(data));
+                ++_size;
+            }
+
+            /**
+             * @brief Discard the captured calls, keeping the memory of the columns
+             */
+            void clear() override {
+                std::apply([](auto &...columns) { (columns.clear(), ...); }, _columns);
+                _cleared = _size;
+            }
+
+            /**
+             * @return number of calls (since index from) matching all the argument comparators
+             */
+            template <typename ...CompareTypes, typename ...ArgComps>
+            uint count(std::size_t from, const ArgComps &...comps) const {
+                std::size_t first = std::max(from, _cleared) - _cleared;
+                std::vector<std::uint8_t> mask(_size - _cleared - first, 1u);
+                filterColumns<CompareTypes...>(std::index_sequence_for<Ts...>(), first, mask, comps...);
+                return static_cast<uint>(std::count(mask.begin(), mask.end(), 1u));
+            }
+
+        private:
+            template <std::size_t ...I, typename ...Args>
+            void appendColumns(std::index_sequence<I...>, const Args &...args) {
+                (std::get<I>(_columns).append(args), ...);
+            }
+
+            template <typename ...CompareTypes, std::size_t ...I, typename ...ArgComps>
+            void filterColumns(std::index_sequence<I...>, [[maybe_unused]] std::size_t from, [[maybe_unused]] std::vector<std::uint8_t> &mask,
+                               const ArgComps &...comps) const {
+                (std::get<I>(_columns).template filter<CompareTypes>(comps, from, mask), ...);
+            }
+
+            std::tuple<Column<std::decay_t<decltype(unwrap(std::declval<const Ts &>()))>>...> _columns;
+        };
+
+    }
+
+    namespace internal {
+
+        template <typename T, typename = void>
+        struct isHashable : std::false_type {};
+        template <typename T>
+        struct isHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T &>()))>>
+                : std::bool_constant<comparator::internal::has_equality<T>::value> {};
+
+        struct TupleHash {
+            template <typename ...Ts>
+            std::size_t operator()(const std::tuple<Ts...> &key) const {
+                std::size_t seed = 0;
+                std::apply([&seed](const auto &...values) {
+                    ((seed ^= std::hash<std::decay_t<decltype(values)>>{}(values) + 0x9e3779b9 + (seed << 6u) + (seed >> 2u)), ...);
+                }, key);
+                return seed;
+            }
+        };
+
+    }
+
     struct MethodCallVerifier {
         using CalledCompare = std::variant<IsNot, AtMost, AtLeast, NeverCalled, VerifyCompare>;
 
@@ -276,10 +865,61 @@ namespace FSeam {
             uint _numberTimeMatched = 0;
         };
 
+        /**
+         * @brief Expectation whose number of matching calls is counted at verify time (deferred expectation evaluated on
+         *        the argument columns, or counter of an indexed expectArgTable row)
+         */
+        struct CountedExpectation {
+            bool operator()() const {
+                uint matched = _evaluate();
+                return std::visit(overload {
+                    [matched](const auto& c) { return c.compare(matched); }
+                }, _comparator);
+            }
+            std::function<uint()> _evaluate;
+
+            CalledCompare _comparator;
+        };
+
         std::string _methodName;
         std::size_t _called = 0;
         std::function<void(void*)> _handler;  
         std::vector<Expectation> _expectations;      
+        std::vector<CountedExpectation> _deferredExpectations;
+        std::shared_ptr<internal::ColumnStoreBase> _columns;
+        // rows of expectArgTable indexed in a hash table, counted by the index probes
+        std::vector<CountedExpectation> _indexedExpectations;
+        std::vector<std::function<void(void*)>> _indexProbes;
+        // reset of the counters kept by the expectations of the method (MockVerifier::reset), cleared with the expectations
+        std::vector<std::function<void()>> _resetHandlers;
+        // reset of the state kept by the dupe handler (MockVerifier::reset), dropped with the handler when it is overridden
+        std::vector<std::function<void()>> _dupeResetHandlers;
+        // counter of the method in the shared registry, looked up at the first call of a registry generation
+        SharedRegistry::Slot *_sharedSlot = nullptr;
+        std::uint64_t _sharedKey = 0;
+        std::uint64_t _sharedGeneration = 0;
+    };
+
+    /**
+     * @brief Row of an expectArgTable: one argument comparator per argument of the method, and a calling comparator
+     */
+    struct ArgRow {
+        ArgRow(std::vector<ArgComp> args, MethodCallVerifier::CalledCompare comparator = AtLeast{1}) :
+                _args(std::move(args)), _comparator(std::move(comparator)) {}
+
+        std::vector<ArgComp> _args;
+        MethodCallVerifier::CalledCompare _comparator;
+    };
+
+    /**
+     * @brief State of the dupeReturnSequence/dupeReturnCycle helpers, values to return and index of the next one
+     */
+    template <typename ReturnType>
+    struct ReturnSequence {
+        explicit ReturnSequence(std::vector<ReturnType> values) : _values(std::move(values)) {}
+
+        std::vector<ReturnType> _values;
+        std::size_t _index = 0;
     };
 
     /**
@@ -290,72 +930,83 @@ namespace FSeam {
      */
     class MockClassVerifier {
     public:
-        explicit MockClassVerifier(std::string className) : _className(std::move(className)) {}
+        explicit MockClassVerifier(std::string className, std::uint64_t sharedId = 0) :
+            _className(std::move(className)), _sharedId(sharedId) {}
 
         /**
          * @note This method should never be used by the client directly, it is a "FSeam generated" method only
          */
-        void invokeDupedMethod(const std::string &methodName, void *arg = nullptr) {
-            std::string key = _className + methodName;
+        void invokeDupedMethod(std::string_view methodName, void *arg = nullptr);
 
-            if (_verifiers.find(key) != _verifiers.end()) {
-                if (auto dupedMethod = _verifiers.at(key)->_handler; dupedMethod)
-                    dupedMethod(arg);
-            }
-        }
+        /**
+         * @brief Same as invokeDupedMethod without reaching the SchedulePoint, for a caller that reaches it itself
+         *        before taking its own lock (see the FSeam-io seam)
+         * @note This method should never be used by the client directly
+         */
+        void invokeDupe(std::string_view methodName, void *arg = nullptr);
 
         /**
          * @note This method should never be used by the client directly, it is a "FSeam generated" method only
          */
-        void methodCall(std::string methodName, void *data) {
-            std::shared_ptr<MethodCallVerifier> methodCallVerifier;
-            std::string key = _className + methodName;
-
-            if (_verifiers.find(key) != _verifiers.end())
-                methodCallVerifier = _verifiers.at(key);
-            else 
-                methodCallVerifier = std::make_shared<MethodCallVerifier>();
-            for (auto &expectation : methodCallVerifier->_expectations)
-                expectation.check(data);
-            methodCallVerifier->_methodName = std::move(methodName);
-            methodCallVerifier->_called += 1;
-            _verifiers[std::move(key)] = methodCallVerifier;
-        }
+        void methodCall(std::string_view methodName, void *data);
 
         /**
          * Clear the expectations of the given method, if none provided, all expectation are removed
          * @param methodName
          */
-        void clearExpectations(std::optional<std::string> methodName = std::nullopt) {
-            if (methodName) {
-                std::string key = _className + std::move(*methodName);
+        void clearExpectations(std::optional<std::string_view> methodName = std::nullopt);
 
-                if (_verifiers.find(key) != _verifiers.end()) {
-                    std::shared_ptr<MethodCallVerifier> &methodCallVerifier = _verifiers.at(key);
-                    methodCallVerifier->_expectations.clear();
-                }
-            }
-            else {
-                for( auto const& [key, val] : _verifiers)
-                    val->_expectations.clear();
-            }
+        /**
+         * @brief Reset the calls of all the methods (see MockVerifier::reset), dupes and expectations stay registered
+         */
+        void reset();
+
+        /**
+         * @brief Calls of the given method recorded in the shared registry (see MockVerifier::shareAcrossProcesses) by all
+         *        the processes, in call order. Only the most recent calls are kept by the ring buffer of the registry.
+         */
+        std::vector<SharedCall> sharedCalls(std::string_view methodName) const;
+
+        /**
+         * @brief Enable (or disable) the deferred expectation mode for the expectations registered afterward
+         * @details By default, each expectation registered with expectArg is checked synchronously inside each call of the
+         *          mocked method (a call costs O(number of expectations)). In deferred mode, a call only appends its
+         *          arguments to per-method column buffers, and all the expectations are evaluated in one batched pass at
+         *          verify time (Eq / NotEq on integral and enum arguments are evaluated with vectorizable loops).
+         *          The mocked call latency doesn't depend on the number of expectations anymore, at the cost of keeping
+         *          a copy of the arguments of each call until the expectations are cleared.
+         *
+         * @param deferred true to defer the expectations evaluation to verify time
+         */
+        void deferExpectations(bool deferred = true) {
+            _deferExpectations = deferred;
+        }
+
+        bool isDeferringExpectations() const {
+            return _deferExpectations;
         }
 
         /**
          * @note This method should never be used by the client directly, it is a "FSeam generated" method only
+         * @tparam CompareTypes type of each argument as declared in the mocked method (used to compare them)
          */
-        void registerExpectation(std::string methodName, MethodCallVerifier::Expectation expectation) {
-            std::shared_ptr<MethodCallVerifier> methodCallVerifier;
-            std::string key = _className + std::move(methodName);
-
-            if (_verifiers.find(key) != _verifiers.end())
-                methodCallVerifier = _verifiers.at(key);
-            else 
-                methodCallVerifier = std::make_shared<MethodCallVerifier>();
-            methodCallVerifier->_expectations.emplace_back(std::move(expectation));
-            _verifiers[std::move(key)] = methodCallVerifier;
+        template <typename ClassMethodIdentifier, typename ...CompareTypes, typename Comparator, typename ...ArgComps>
+        void registerDeferredExpectation(Comparator comp, ArgComps ... comps) {
+            auto &methodCallVerifier = getMethodCallVerifier(ClassMethodIdentifier::NAME);
+
+            if (!methodCallVerifier->_columns)
+                methodCallVerifier->_columns = std::make_shared<internal::ColumnStore<ClassMethodIdentifier>>();
+            auto columns = std::static_pointer_cast<internal::ColumnStore<ClassMethodIdentifier>>(methodCallVerifier->_columns);
+            std::size_t from = columns->_size;
+            methodCallVerifier->_deferredExpectations.emplace_back(MethodCallVerifier::CountedExpectation{
+                    [columns, from, comps...]() { return columns->template count<CompareTypes...>(from, comps...); }, comp });
         }
 
+        /**
+         * @note This method should never be used by the client directly, it is a "FSeam generated" method only
+         */
+        void registerExpectation(std::string_view methodName, MethodCallVerifier::Expectation expectation);
+
         /**
          * @details Add an expectation on the specified method (template specification on a FSeam generated structure representing
          *        a specific method for a mocked class).
@@ -382,24 +1033,189 @@ namespace FSeam {
          * }
          * @endcode
          *
+         * @note The generated specialization of the method is used if any (see SpecializedExpectations), a generic
+         *       implementation based on the method identifier accessors otherwise.
+         *
          * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
-         * @tparam Verifiers could be simple type (in this case the comparator FSeam::Eq is being called) or any Comparator,
+         * @tparam Verifiers one FSeam::ArgComp per argument (FSeam::Eq, FSeam::NotEq, FSeam::Any...), optionally followed by
+         *         a calling comparator (FSeam::AtLeast{1} by default)
          * @param verifiers comparator used in order to check the arguments of the method identified by ClassMethodIdentifier
          * @return true if the method has been called at least once, false otherwise
          */
         template <typename ClassMethodIdentifier, typename ...Verifiers>
-        void expectArg(Verifiers ... verifiers);
+        void expectArg(Verifiers ... verifiers) {
+            using Comparator = typename internal::CalledComparatorOf<Verifiers...>::type;
+            if constexpr (ClassMethodIdentifier::Specializations::template contains<Comparator>)
+                expectArgSpecialized<ClassMethodIdentifier, Verifiers...>(verifiers...);
+            else
+                expectArgGeneric<ClassMethodIdentifier>(std::make_tuple(verifiers...),
+                        static_cast<typename ClassMethodIdentifier::ArgsCompare *>(nullptr),
+                        std::make_index_sequence<std::tuple_size_v<typename ClassMethodIdentifier::ArgsCompare>>());
+        }
+
+        /**
+         * @brief Register a table of argument expectations on the specified method, each row being equivalent to a call to
+         *        expectArg with the row comparators.
+         * @details Rows made only of FSeam::Eq comparators on hashable arguments are indexed in a hash table: a call of the
+         *          mocked method does a single lookup to find the matching rows instead of checking every expectation.
+         *          Other rows are registered through expectArg (checked linearly at each call).
+         *
+         * @example
+         * @code
+         * fseamMock->expectArgTable<FSeam::ClassName::functionName>({
+         *     {{FSeam::Eq(1), FSeam::Eq(std::string("one"))}, FSeam::VerifyCompare{1}},
+         *     {{FSeam::Eq(2), FSeam::Eq(std::string("two"))}},   // AtLeast{1} by default
+         *     {{FSeam::NotEq(3), FSeam::Any()}, FSeam::NeverCalled{}}  // not indexed
+         * });
+         * @endcode
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         * @param rows expectations, the number of argument comparators of a row has to match the number of argument of the method
+         */
+        template <typename ClassMethodIdentifier>
+        void expectArgTable(const std::vector<ArgRow> &rows) {
+            registerArgTable<ClassMethodIdentifier>(rows, static_cast<decltype(ClassMethodIdentifier::args(nullptr)) *>(nullptr));
+        }
 
         /**
          * @brief Call dupeMethod in order to set the set the correct return value
          * @note The duping is done in a composed way, calling dupeReturn won't override current dupe
          * 
          * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
-         * @tparam ReturnType Return type of the function to mock
+         * @tparam ReturnType Return type of the function to mock (converted to the return type of the method)
          * @param ret return value to return when the mocked method is called
          */
         template <typename ClassMethodIdentifier, typename ReturnType>
-        void dupeReturn(ReturnType ret);
+        void dupeReturn(ReturnType ret) {
+            using MethodReturnType = std::decay_t<decltype(ClassMethodIdentifier::returnValue(nullptr))>;
+            if constexpr (ClassMethodIdentifier::DUPE_RETURN_SPECIALIZED)
+                dupeReturnSpecialized<ClassMethodIdentifier, MethodReturnType>(std::move(ret));
+            else
+                this->dupeMethod(ClassMethodIdentifier::NAME, [ret = MethodReturnType(std::move(ret))](void *methodCallData) {
+                    ClassMethodIdentifier::returnValue(methodCallData) = ret;
+                }, true);
+        }
+
+        /**
+         * @brief Dupe the return value of the given method with a sequence of values: the first call returns the first value,
+         *        the second call the second value and so on. Once the sequence is over, the last value is returned forever.
+         * @details Values are stored contiguously and returned by advancing an index (O(1) per call), they are moved out
+         *          when returned (except the last one that is copied, if copyable, as it is returned forever).
+         *          A move-only last value can only be returned once: the calls after it return the default value of
+         *          the method and log an error.
+         * @note The duping is done in a composed way, calling dupeReturnSequence won't override current dupe
+         *
+         * @example
+         * @code
+         * // return 1, then 2, then -1 forever
+         * fseamMock->dupeReturnSequence<FSeam::ClassName::functionName>({1, 2, -1});
+         * @endcode
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         * @tparam ReturnType Return type of the function to mock (deduced from the method identifier)
+         * @param values values to return in order
+         */
+        template <typename ClassMethodIdentifier,
+                  typename ReturnType = std::decay_t<decltype(ClassMethodIdentifier::returnValue(nullptr))> >
+        void dupeReturnSequence(std::vector<ReturnType> values) {
+            if (values.empty())
+                return;
+            this->dupeMethod(ClassMethodIdentifier::NAME,
+                    [sequence = std::make_shared<ReturnSequence<ReturnType> >(std::move(values))](void *data) {
+                auto &returnValue = ClassMethodIdentifier::returnValue(data);
+                if (sequence->_index + 1 < sequence->_values.size())
+                    returnValue = std::move(sequence->_values[sequence->_index++]);
+                else if constexpr (std::is_copy_assignable<ReturnType>())
+                    returnValue = sequence->_values.back();
+                else if (sequence->_index < sequence->_values.size())
+                    returnValue = std::move(sequence->_values[sequence->_index++]);
+                else
+                    Logging::Logger::log(Logging::Level::ERROR, "dupeReturnSequence error for method " +
+                            std::string(ClassMethodIdentifier::CLASS_NAME) + "::" + std::string(ClassMethodIdentifier::NAME) +
+                            ", the move-only last value has already been returned \n");
+            }, true);
+        }
+
+        /**
+         * @brief Dupe the return value of the given method with values returned in a loop: once the last value is returned,
+         *        the next call returns the first value again.
+         * @note The values are copied at each call, the return type has to be copy assignable
+         * @note The duping is done in a composed way, calling dupeReturnCycle won't override current dupe
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         * @tparam ReturnType Return type of the function to mock (deduced from the method identifier)
+         * @param values values to return in a loop
+         */
+        template <typename ClassMethodIdentifier,
+                  typename ReturnType = std::decay_t<decltype(ClassMethodIdentifier::returnValue(nullptr))> >
+        void dupeReturnCycle(std::vector<ReturnType> values) {
+            static_assert(std::is_copy_assignable<ReturnType>(),
+                    "dupeReturnCycle returns each value several times, the return type has to be copy assignable (see dupeReturnSequence)");
+            if (values.empty())
+                return;
+            this->dupeMethod(ClassMethodIdentifier::NAME,
+                    [sequence = std::make_shared<ReturnSequence<ReturnType> >(std::move(values))](void *data) {
+                ClassMethodIdentifier::returnValue(data) = sequence->_values[sequence->_index];
+                sequence->_index = (sequence->_index + 1) % sequence->_values.size();
+            }, true);
+        }
+
+        /**
+         * @brief Dupe the asynchronous return value of the given method (std::future, std::shared_future or an awaitable
+         *        type with AsyncReturn traits): each call returns a pending result, completed with the given value when
+         *        the test runs its completion on the FSeam::AsyncExecutor
+         * @note The duping is done in a composed way, calling dupeAsyncReturn won't override current dupe
+         *
+         * @example
+         * @code
+         * fseamMock->dupeAsyncReturn<FSeam::ClassName::functionName>(std::string("value"), std::chrono::milliseconds(5));
+         * client.sendRequests();
+         * FSeam::AsyncExecutor::runReverse(); // or run(id), runNext(), advance(duration), runShuffled(seed)...
+         * @endcode
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         * @tparam Executor executor on which the completions are posted, FSeam::AsyncExecutor (FSeamAsync.hpp has to be included)
+         * @param value value completing each result
+         * @param delay due time of the completion after the call on the virtual clock (duration or count of nanoseconds)
+         */
+        template <typename ClassMethodIdentifier, typename ValueType, typename Delay = VirtualClock::duration,
+                  typename Executor = AsyncExecutor>
+        void dupeAsyncReturn(ValueType value, Delay delay = Delay{}) {
+            using Awaitable = std::decay_t<decltype(ClassMethodIdentifier::returnValue(nullptr))>;
+            using Traits = AsyncReturn<Awaitable>;
+            static_assert(Traits::IS_ASYNC, "Return type should be a std::future, a std::shared_future or have FSeam::AsyncReturn traits");
+            this->dupeMethod(ClassMethodIdentifier::NAME, [value = std::move(value), delay = VirtualClock::toDuration(delay)](void *data) {
+                auto promise = std::make_shared<typename Traits::Promise>();
+                ClassMethodIdentifier::returnValue(data) = Traits::awaitable(*promise);
+                Executor::post([promise, value]() { Traits::complete(*promise, value); }, delay);
+            }, true);
+        }
+
+        /**
+         * @brief Dupe the return value of the given method with a value taken from the FSeam::FuzzInput at each call: the
+         *        fuzzer drives what the mocked dependencies return
+         * @note The duping is done in a composed way, calling dupeFromFuzzInput won't override current dupe
+         *
+         * @example
+         * @code
+         * extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size) {
+         *     static source::Service service = setupService(); // dupeFromFuzzInput<FSeam::Dependency::read>() on its dependency
+         *     FSeam::FuzzInput::set(data, size);
+         *     service.process();
+         *     FSeam::MockVerifier::reset();
+         *     return 0;
+         * }
+         * @endcode
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         */
+        template <typename ClassMethodIdentifier>
+        void dupeFromFuzzInput() {
+            this->dupeMethod(ClassMethodIdentifier::NAME, [](void *data) {
+                auto &returnValue = ClassMethodIdentifier::returnValue(data);
+                returnValue = FuzzInput::consume<std::decay_t<decltype(returnValue)>>();
+            }, true);
+        }
 
         /**
          * @brief This method make it possible to dupe a method in order to have it do what you want.
@@ -414,24 +1230,104 @@ namespace FSeam {
          * @param isComposed if true, compose a new handler with the current one and the provided one,
          *         if false, override the existing handler if any. Set at false by default
          */
-        void dupeMethod(std::string methodName, const std::function<void(void*)> &handler, bool isComposed = false) {
-            auto methodCallVerifier = std::make_shared<MethodCallVerifier>();
-            std::string key = _className + methodName;
-
-            if (_verifiers.find(key) != _verifiers.end())
-                methodCallVerifier = _verifiers.at(key);
-            methodCallVerifier->_methodName = std::move(methodName);
-            if (isComposed && methodCallVerifier->_handler) {
-                methodCallVerifier->_handler = [currentHandler = methodCallVerifier->_handler, handler](void *data){
-                    currentHandler(data);
-                    handler(data);
-                };
-            }
-            else {
-                methodCallVerifier->_called = 0;
-                methodCallVerifier->_handler = handler;
-            }
-            _verifiers[std::move(key)] = methodCallVerifier;
+        void dupeMethod(std::string_view methodName, const std::function<void(void*)> &handler, bool isComposed = false);
+
+        /**
+         * @brief Dupe the time spent into the given method, each call sleeps on the FSeam::VirtualClock for a duration taken
+         *        from the provided distribution
+         * @note The duping is done in a composed way, calling dupeLatency won't override current dupe
+         *
+         * @example
+         * @code
+         * fseamMock->dupeLatency<FSeam::ClassName::functionName>(FSeam::Latency::Fixed(std::chrono::milliseconds(200)));
+         * fseamMock->dupeLatency<FSeam::ClassName::functionName>(
+         *         FSeam::Latency::Uniform(std::chrono::milliseconds(10), std::chrono::milliseconds(50), seed));
+         * @endcode
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         * @tparam Distribution latency distribution (FSeam::Latency::Fixed, FSeam::Latency::Uniform, FSeam::Latency::Histogram
+         *         of FSeamLatency.hpp, or any type providing a next() method returning a duration)
+         * @param distribution distribution from which delays are drawn at each call
+         */
+        template <typename ClassMethodIdentifier, typename Distribution>
+        void dupeLatency(Distribution distribution) {
+            this->dupeMethod(ClassMethodIdentifier::NAME, [dist = std::make_shared<Distribution>(std::move(distribution))](void *) {
+                VirtualClock::sleepFor(dist->next());
+            }, true);
+        }
+
+        /**
+         * @brief Dupe the return value of the given method with the current time of the FSeam::VirtualClock.
+         *        To be used on the (mocked) functions through which the tested code reads the time.
+         * @note The duping is done in a composed way, calling dupeVirtualClock won't override current dupe
+         *
+         * @example
+         * @code
+         * // std::chrono::steady_clock::time_point source::steadyNow();  (wrapper header mocked by FSeam)
+         * FSeam::getFreeFunc()->dupeVirtualClock<FSeam::FreeFunction::steadyNow>();
+         * // std::int64_t source::epochMillis();
+         * FSeam::getFreeFunc()->dupeVirtualClock<FSeam::FreeFunction::epochMillis, std::chrono::milliseconds>();
+         * @endcode
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         * @tparam Unit unit of the returned value if the method return an arithmetic type (nanoseconds by default)
+         */
+        template <typename ClassMethodIdentifier, typename Unit = std::chrono::nanoseconds>
+        void dupeVirtualClock() {
+            this->dupeMethod(ClassMethodIdentifier::NAME, [](void *data) {
+                auto &returnValue = ClassMethodIdentifier::returnValue(data);
+                returnValue = VirtualClock::as<std::decay_t<decltype(returnValue)>, Unit>();
+            }, true);
+        }
+
+        /**
+         * @brief Dupe a sleeping method: the first argument of the method (a duration, or an arithmetic count of Unit) is
+         *        slept on the FSeam::VirtualClock, which means the virtual time is moved forward without blocking.
+         * @note The duping is done in a composed way, calling dupeVirtualSleep won't override current dupe
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         * @tparam Unit unit of the first argument if it is an arithmetic type (nanoseconds by default)
+         */
+        template <typename ClassMethodIdentifier, typename Unit = std::chrono::nanoseconds>
+        void dupeVirtualSleep() {
+            this->dupeMethod(ClassMethodIdentifier::NAME, [](void *data) {
+                auto &&duration = std::get<0>(ClassMethodIdentifier::args(data));
+                if (duration)
+                    VirtualClock::sleepFor(VirtualClock::toDuration<Unit>(internal::unwrap(*duration)));
+            }, true);
+        }
+
+        /**
+         * @brief Throttle the given method with a token bucket, each call consumes a token.
+         *        When the bucket is exhausted, the call either blocks on the FSeam::VirtualClock until a token is refilled, or
+         *        if an exhausted handler is provided, calls this handler instead (in order to set a failure return value for example)
+         * @note The duping is done in a composed way, calling dupeRateLimit won't override current dupe. As handlers are called
+         *       in registration order, the rate limit should be set after any dupeReturn it has to override on failure
+         *
+         * @tparam ClassMethodIdentifier identifier structure generated by FSeam which represent a specific method of a specific class
+         * @tparam Bucket FSeam::Latency::TokenBucket (FSeamLatency.hpp has to be included)
+         * @param bucket token bucket used to throttle the calls
+         * @param onExhausted handler called (with the method call data structure) instead of blocking when no token is available
+         */
+        template <typename ClassMethodIdentifier, typename Bucket = Latency::TokenBucket>
+        void dupeRateLimit(Bucket bucket, std::function<void(void*)> onExhausted = nullptr) {
+            auto sharedBucket = std::make_shared<Bucket>(std::move(bucket));
+            this->dupeMethod(ClassMethodIdentifier::NAME, [bucket = sharedBucket, onExhausted](void *data) {
+                if (bucket->tryAcquire())
+                    return;
+                if (onExhausted) {
+                    onExhausted(data);
+                    return;
+                }
+                VirtualClock::sleepFor(bucket->timeToNextToken());
+                bucket->tryAcquire();
+            }, true);
+            // registered after the handler (a dupe overriding it drops the reset), the virtual clock being rewound by a
+            // reset, the bucket starts full again
+            getMethodCallVerifier(ClassMethodIdentifier::NAME)->_dupeResetHandlers.emplace_back([sharedBucket]() {
+                sharedBucket->_tokens = sharedBucket->_capacity;
+                sharedBucket->_lastRefill = VirtualClock::elapsed();
+            });
         }
 
         /**
@@ -441,7 +1337,7 @@ namespace FSeam {
          * @param verbose flag if a debug string is required in case of false response (set to true by default)
          * @return true if the method encounter the provided comparator conditions, false otherwise
          */
-        bool verify(const std::string &methodName, bool verbose = true) const {
+        bool verify(std::string_view methodName, bool verbose = true) const {
             return verify(methodName, AtLeast(1), verbose);
         }
 
@@ -462,64 +1358,195 @@ namespace FSeam {
          * @return true if the method encounter the provided comparator conditions, false otherwise
          */
         template <typename Comparator>
-        bool verify(std::string methodName, Comparator &&comp, bool verbose = true) const {
-            if constexpr (std::is_integral<Comparator>())
-                return verify(std::move(methodName), VerifyCompare{ static_cast<uint>(comp) }, verbose);
+        bool verify(std::string_view methodName, Comparator &&comp, bool verbose = true) const {
+            if constexpr (std::is_integral<std::decay_t<Comparator>>())
+                return verify(methodName, VerifyCompare{ static_cast<uint>(comp) }, verbose);
             else {
-                static_assert(isCalledComparator<Comparator>::v, "Type  should be AtLeast, AtMost, Never, IsNot or VerifyCompare");
-                std::string key = _className + std::move(methodName);
+                static_assert(isCalledComparator<std::decay_t<Comparator>>::v, "Type  should be AtLeast, AtMost, Never, IsNot or VerifyCompare");
+                std::string error;
+                bool result = verifyCalls(methodName, comp, verbose ? &error : nullptr);
+                // logged from the caller translation unit (the logging depends on the testing framework used)
+                if (!error.empty())
+                    Logging::Logger::log(Logging::Level::ERROR, error);
+                return result;
+            }
+        }
 
-                if (_verifiers.find(key) == _verifiers.end()) {
-                    if (verbose && comp._toCompare > 0u) {
-                        Logging::Logger::log(Logging::Level::ERROR,
-                                "Verify error for method " + key + ", method never have been called while " + comp.expectStr(0u) + " method call \n");
+    private:
+        /**
+         * @param error if not null, set with the reason of the failure of the verification on the number of calls
+         */
+        bool verifyCalls(std::string_view methodName, MethodCallVerifier::CalledCompare comp, std::string *error) const;
+
+        /**
+         * @return the calls/expectations registered on the given method, created if not registered yet
+         */
+        std::shared_ptr<MethodCallVerifier> &getMethodCallVerifier(std::string_view methodName);
+
+        /**
+         * @note Specialized by the FSeam generated code (FSeamSpecialization.cpp), not defined otherwise
+         */
+        template <typename ClassMethodIdentifier, typename ...Verifiers>
+        void expectArgSpecialized(Verifiers ... verifiers);
+
+        /**
+         * @note Specialized by the FSeam generated code (FSeamSpecialization.cpp), not defined otherwise
+         */
+        template <typename ClassMethodIdentifier, typename ReturnType>
+        void dupeReturnSpecialized(ReturnType ret);
+
+        template <typename ClassMethodIdentifier, typename ...Verifiers, typename ...CompareTypes, std::size_t ...I>
+        void expectArgGeneric(std::tuple<Verifiers...> verifiers, std::tuple<CompareTypes...> *, std::index_sequence<I...>) {
+            static_assert(sizeof...(Verifiers) == sizeof...(I) || sizeof...(Verifiers) == sizeof...(I) + 1,
+                    "expectArg requires one FSeam::ArgComp per argument of the method, optionally followed by a calling comparator");
+            MethodCallVerifier::CalledCompare comp = AtLeast{1};
+            if constexpr (sizeof...(Verifiers) > sizeof...(I))
+                comp = std::get<sizeof...(I)>(verifiers);
+            if (this->isDeferringExpectations()) {
+                std::visit([this, &verifiers](auto c) {
+                    this->registerDeferredExpectation<ClassMethodIdentifier, typename internal::DeferredCompare<CompareTypes>::type...>(
+                            c, ArgComp(std::get<I>(verifiers))...);
+                }, comp);
+                return;
+            }
+            std::array<ArgComp, sizeof...(I)> args {ArgComp(std::get<I>(verifiers))...};
+            this->registerExpectation(ClassMethodIdentifier::NAME, MethodCallVerifier::Expectation{ [args](void *methodCallData) {
+                [[maybe_unused]] auto values = ClassMethodIdentifier::args(methodCallData);
+                // an argument that couldn't be captured doesn't match (as for the deferred expectations)
+                return ((std::get<I>(values).has_value() && args[I].template compare<CompareTypes>(*std::get<I>(values))) && ...);
+            }, comp });
+        }
+
+        template <typename ClassMethodIdentifier, typename ...Ts>
+        void registerArgTable(const std::vector<ArgRow> &rows, std::tuple<std::optional<Ts>&...> *) {
+            using Key = std::tuple<std::decay_t<decltype(internal::unwrap(std::declval<const Ts &>()))>...>;
+            using Index = std::unordered_map<Key, std::vector<std::size_t>, internal::TupleHash>;
+            constexpr bool indexable = sizeof...(Ts) > 0 &&
+                    std::conjunction_v<internal::isHashable<std::decay_t<decltype(internal::unwrap(std::declval<const Ts &>()))>>...>;
+            std::shared_ptr<Index> index;
+            auto counters = std::make_shared<std::vector<uint>>();
+
+            for (const auto &row : rows) {
+                if (row._args.size() != sizeof...(Ts)) {
+                    Logging::Logger::log(Logging::Level::ERROR, "expectArgTable error for method " + _className +
+                            std::string(ClassMethodIdentifier::NAME) + ", a row has " +
+                            std::to_string(row._args.size()) + " argument comparators instead of " + std::to_string(sizeof...(Ts)) + "\n");
+                    continue;
+                }
+                if constexpr (indexable) {
+                    if (auto indexKey = toIndexKey<Key>(row._args, std::index_sequence_for<Ts...>()); indexKey) {
+                        std::size_t rowIndex = counters->size();
+                        if (!index)
+                            index = std::make_shared<Index>();
+                        counters->emplace_back(0u);
+                        (*index)[std::move(*indexKey)].emplace_back(rowIndex);
+                        getMethodCallVerifier(ClassMethodIdentifier::NAME)->_indexedExpectations.emplace_back(MethodCallVerifier::CountedExpectation{
+                                [counters, rowIndex]() { return counters->at(rowIndex); }, row._comparator });
+                        continue;
                     }
-                    return comp._toCompare == 0u;
                 }
-                bool result = comp.compare(_verifiers.at(key)->_called);
-                if (verbose && !result) {
-                    Logging::Logger::log(Logging::Level::ERROR,
-                                         "Verify error for method " + key + ", method has been called but " +
-                                                 comp.expectStr(_verifiers.at(key)->_called) + " method call \n");
+                std::visit([this, &row](auto comp) {
+                    expectArgRow<ClassMethodIdentifier>(row._args, comp, std::index_sequence_for<Ts...>());
+                }, row._comparator);
+            }
+            if constexpr (indexable) {
+                if (index) {
+                    getMethodCallVerifier(ClassMethodIdentifier::NAME)->_resetHandlers.emplace_back([counters]() {
+                        std::fill(counters->begin(), counters->end(), 0u);
+                    });
+                    getMethodCallVerifier(ClassMethodIdentifier::NAME)->_indexProbes.emplace_back([index, counters](void *data) {
+                        auto args = ClassMethodIdentifier::args(data);
+                        bool complete = std::apply([](const auto &...arg) { return (arg.has_value() && ...); }, args);
+                        if (!complete)
+                            return;
+                        auto found = index->find(std::apply([](const auto &...arg) { return Key{internal::unwrap(*arg)...}; }, args));
+                        if (found == index->end())
+                            return;
+                        for (std::size_t rowIndex : found->second)
+                            ++(*counters)[rowIndex];
+                    });
                 }
-                for (auto &expect : _verifiers.at(key)->_expectations)
-                    result &= expect();
-                return result;
             }
         }
 
+        template <typename Key, std::size_t ...I>
+        static std::optional<Key> toIndexKey(const std::vector<ArgComp> &args, std::index_sequence<I...>) {
+            if (!(std::holds_alternative<comparator::internal::Eq>(args[I]._comp) && ...))
+                return std::nullopt;
+            if (!(std::any_cast<std::tuple_element_t<I, Key>>(std::get<comparator::internal::Eq>(args[I]._comp)._toCompare.get()) && ...))
+                return std::nullopt;
+            return Key{std::any_cast<std::tuple_element_t<I, Key>>(*std::get<comparator::internal::Eq>(args[I]._comp)._toCompare)...};
+        }
+
+        template <typename ClassMethodIdentifier, typename Comparator, std::size_t ...I>
+        void expectArgRow(const std::vector<ArgComp> &args, Comparator comp, std::index_sequence<I...>) {
+            expectArg<ClassMethodIdentifier, IndexedArgComp<I>..., Comparator>(args[I]..., comp);
+        }
+
+        template <std::size_t>
+        using IndexedArgComp = ArgComp;
+
     private:
         std::string _className;
-        std::map<std::string, std::shared_ptr<MethodCallVerifier> > _verifiers;
+        // identifier of the mock in the shared registry, the same in the forked processes
+        std::uint64_t _sharedId;
+        // registered methods by name, looked up without allocation (std::less<> compares with std::string_view)
+        std::map<std::string, std::shared_ptr<MethodCallVerifier>, std::less<> > _verifiers;
+        bool _deferExpectations = false;
     };
 
     /**
      * @brief Mocking singleton, this is the main class of FSeam class contains all the mock
      */
     class MockVerifier {
-        inline static std::unique_ptr<MockVerifier> inst = nullptr;
+        static std::unique_ptr<MockVerifier> inst;
 
     public:
         MockVerifier() = default;
         ~MockVerifier() = default;
 
-        static MockVerifier &instance() {
-            if (inst == nullptr) {
-                inst = std::make_unique<MockVerifier>();
-            };
-            return *(inst.get());
-        }
+        static MockVerifier &instance();
 
         /**
          * @brief Clean the FSeam context of all previously set mock behaviors
          */
-        static void cleanUp() {
-            inst.reset(nullptr);
-        }
+        static void cleanUp();
 
-        bool isMockRegistered(const void *mockPtr) {
-            return this->_mockedClass.find(mockPtr) != this->_mockedClass.end();
-        }
+        /**
+         * @brief Reset the FSeam context between two iterations of a loop (fuzzing target for instance) without releasing
+         *        any memory: the calls, matched expectations and captured arguments are cleared, the virtual clock is
+         *        rewound, the pending completions of the AsyncExecutor are dropped, but the mocks, their dupes and their
+         *        expectations stay registered.
+         * @note The state of the dupes is kept (position in a dupeReturnSequence / dupeReturnCycle for instance)
+         */
+        static void reset();
+
+        /**
+         * @brief Count the calls of the mocks in a shared memory segment, in order to verify the calls made by the
+         *        processes forked afterward (fork of the tested code for instance)
+         * @details The mocks, their dupes and their expectations are inherited through fork (copy of the process memory),
+         *          but the calls made in a child process are only counted in its own copy of the FSeam context. With the
+         *          shared registry, the calls made in any process are counted in the segment and verify aggregates them.
+         *          The arguments expectations (expectArg) are still evaluated in each process on its own calls.
+         *          The mocks to verify have to be registered (FSeam::get) before the fork, the segment is released by
+         *          cleanUp (the forked processes should leave with _exit, without cleaning up the FSeam context).
+         *
+         *          The calls made before are counted as well. If more methods are called than the slots, verify fails
+         *          on the methods that couldn't be counted.
+         *
+         * @param slots maximum number of methods counted
+         * @param records size of the ring buffer of call records (see MockClassVerifier::sharedCalls)
+         * @return false if the segment couldn't be mapped
+         */
+        static bool shareAcrossProcesses(std::size_t slots = 4096, std::size_t records = 65536);
+
+        /**
+         * @brief Drop the pending completions of the FSeam::AsyncExecutor (FSeamAsync.hpp) on reset and cleanUp, set by
+         *        the executor once a completion is posted
+         */
+        inline static std::atomic<void (*)()> clearCompletions = nullptr;
+
+        bool isMockRegistered(const void *mockPtr);
 
         /**
          * @brief This method get the MockClassVerifier instance class
@@ -529,11 +1556,7 @@ namespace FSeam {
          * @param classMockName name of the class to mock (provided by TypeParseTraits)
          * @return a MockClassVerifier shared_ptr class, if not referenced yet, create one by calling the ::addMock(T) method
          */
-        std::shared_ptr<MockClassVerifier> &getMock(const void *mockPtr, const std::string &classMockName) {
-            if (!isMockRegistered(mockPtr))
-                return addMock(mockPtr, classMockName);
-            return this->_mockedClass.at(mockPtr);
-        }
+        std::shared_ptr<MockClassVerifier> &getMock(const void *mockPtr, std::string_view classMockName);
 
         /**
          * @brief This method get the default MockClassVerifier for a class type
@@ -542,25 +1565,15 @@ namespace FSeam {
          * @param classMockName name of the class to mock (provided by FSeam::TypeParseTraits)
          * @return a MockClassVerifier shared_ptr class, if not referenced yet, create one by calling the ::addDefaultMock(T) method
          */
-        std::shared_ptr<MockClassVerifier> &getDefaultMock(const std::string &classMockName) {
-            if (this->_defaultMockedClass.find(classMockName) == this->_defaultMockedClass.end())
-                return addDefaultMock(classMockName);
-            return this->_defaultMockedClass.at(classMockName);
-        }
+        std::shared_ptr<MockClassVerifier> &getDefaultMock(std::string_view classMockName);
 
     private:
-        std::shared_ptr<MockClassVerifier> &addMock(const void *mockPtr, const std::string &className) {
-            this->_mockedClass[mockPtr] = std::make_shared<MockClassVerifier>(className);
-            return this->_mockedClass.at(mockPtr);
-        }
-        std::shared_ptr<MockClassVerifier> &addDefaultMock(const std::string &className) {
-            this->_defaultMockedClass[className] = std::make_shared<MockClassVerifier>(className);
-            return this->_defaultMockedClass.at(className);
-        }
+        std::shared_ptr<MockClassVerifier> &addMock(const void *mockPtr, std::string_view className);
+        std::shared_ptr<MockClassVerifier> &addDefaultMock(std::string_view className);
 
     private:
         std::map<const void*, std::shared_ptr<MockClassVerifier> > _mockedClass;
-        std::map<std::string, std::shared_ptr<MockClassVerifier> > _defaultMockedClass;
+        std::map<std::string, std::shared_ptr<MockClassVerifier>, std::less<> > _defaultMockedClass;
     };
 
     // ------------------------ Helper Client Free functions --------------------------
@@ -603,4 +1616,8 @@ namespace FSeam {
 
 }
 
+#ifdef FSEAM_HEADER_ONLY
+#include "FSeamImpl.hpp"
+#endif
+
 #endif //FREESOULS_MOCKVERIFIER_HH
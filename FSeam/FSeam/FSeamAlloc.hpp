@@ -0,0 +1 @@
+../FSeamAlloc.hpp
\ No newline at end of file
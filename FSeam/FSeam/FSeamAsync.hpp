@@ -0,0 +1 @@
+../FSeamAsync.hpp
\ No newline at end of file
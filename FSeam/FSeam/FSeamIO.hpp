@@ -0,0 +1 @@
+../FSeamIO.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../FSeamImpl.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../FSeamLatency.hpp
\ No newline at end of file
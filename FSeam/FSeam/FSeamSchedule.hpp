@@ -0,0 +1 @@
+../FSeamSchedule.hpp
\ No newline at end of file
@@ -0,0 +1,266 @@
+//
+// Created by FyS on 19/10/26.
+//
+
+// Allocation counting seam compiled into the FSeam-alloc library: linking it replaces the global operator new / delete
+// (and on glibc the malloc family) of the test executable
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+#include <execinfo.h>
+#include <malloc.h>
+#endif
+
+#include "FSeamAlloc.hpp"
+
+// Define FSEAM_ALLOC_NO_MALLOC_SEAM in order to count the C++ allocations only (sanitizers replacing malloc for example)
+#if defined(__GLIBC__) && !defined(FSEAM_ALLOC_NO_MALLOC_SEAM)
+#define FSEAM_ALLOC_MALLOC_SEAM
+extern "C" {
+    void *__libc_malloc(std::size_t size);
+    void *__libc_calloc(std::size_t count, std::size_t size);
+    void *__libc_realloc(void *ptr, std::size_t size);
+    void *__libc_memalign(std::size_t alignment, std::size_t size);
+    void __libc_free(void *ptr);
+}
+#endif
+
+// the counters are accessed from malloc, the dynamic TLS allocation (__tls_get_addr) of a shared object would recurse
+#if defined(__GNUC__)
+#define FSEAM_ALLOC_TLS __attribute__((tls_model("initial-exec")))
+#else
+#define FSEAM_ALLOC_TLS
+#endif
+
+namespace {
+
+    // constant initialized and trivially destructible : usable before the thread is fully started
+    struct ThreadState {
+        FSeam::AllocCounters counters;
+        FSeam::AllocScope *scope = nullptr;
+        unsigned untracked = 0;
+    };
+
+    thread_local ThreadState threadState FSEAM_ALLOC_TLS;
+
+    void *rawAllocate(std::size_t size) {
+#ifdef FSEAM_ALLOC_MALLOC_SEAM
+        return __libc_malloc(size ? size : 1);
+#else
+        return std::malloc(size ? size : 1);
+#endif
+    }
+
+    void *rawAllocateAligned(std::size_t size, std::size_t alignment) {
+#ifdef FSEAM_ALLOC_MALLOC_SEAM
+        return __libc_memalign(alignment, size ? size : 1);
+#else
+        void *ptr = nullptr;
+        return posix_memalign(&ptr, alignment, size ? size : 1) ? nullptr : ptr;
+#endif
+    }
+
+    void rawFree(void *ptr) {
+#ifdef FSEAM_ALLOC_MALLOC_SEAM
+        __libc_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    void *allocate(std::size_t size) {
+        FSeam::recordAllocation(size);
+        return rawAllocate(size);
+    }
+
+    void *allocateAligned(std::size_t size, std::align_val_t alignment) {
+        FSeam::recordAllocation(size);
+        return rawAllocateAligned(size, static_cast<std::size_t>(alignment));
+    }
+
+    void deallocate(void *ptr) {
+        if (!ptr)
+            return;
+        FSeam::recordDeallocation();
+        rawFree(ptr);
+    }
+
+    void *checked(void *ptr) {
+        if (!ptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+
+}
+
+namespace FSeam {
+
+    void recordAllocation(std::size_t size) {
+        ThreadState &state = threadState;
+        if (state.untracked)
+            return;
+        ++state.counters.allocations;
+        state.counters.bytes += size;
+        if (state.scope)
+            state.scope->sample(size);
+    }
+
+    void recordDeallocation() {
+        ThreadState &state = threadState;
+        if (!state.untracked)
+            ++state.counters.deallocations;
+    }
+
+    AllocScope::Untracked::Untracked() {
+        ++threadState.untracked;
+    }
+
+    AllocScope::Untracked::~Untracked() {
+        --threadState.untracked;
+    }
+
+    AllocScope::AllocScope(std::size_t sampledStacks) : _parent(threadState.scope), _sampledStacks(sampledStacks) {
+        Untracked untracked;
+        if (_sampledStacks) {
+            _samples.reserve(_sampledStacks);
+#ifdef __GLIBC__
+            // the first backtrace loads the unwinder (allocating)
+            void *frame;
+            backtrace(&frame, 1);
+#endif
+        }
+        threadState.scope = this;
+        _begin = threadState.counters;
+    }
+
+    AllocScope::~AllocScope() {
+        threadState.scope = _parent;
+    }
+
+    std::size_t AllocScope::allocations() const {
+        return threadState.counters.allocations - _begin.allocations;
+    }
+
+    std::size_t AllocScope::deallocations() const {
+        return threadState.counters.deallocations - _begin.deallocations;
+    }
+
+    std::size_t AllocScope::bytes() const {
+        return threadState.counters.bytes - _begin.bytes;
+    }
+
+    AllocCounters AllocScope::threadCounters() {
+        return threadState.counters;
+    }
+
+    void AllocScope::sample(std::size_t size) {
+        if (_samples.size() >= _sampledStacks)
+            return;
+        Untracked untracked;
+        AllocSample sample;
+        sample.size = size;
+#ifdef __GLIBC__
+        sample.depth = backtrace(sample.frames.data(), static_cast<int>(sample.frames.size()));
+#endif
+        // capacity reserved by the constructor
+        _samples.push_back(sample);
+    }
+
+    bool AllocScope::verifyCount(std::size_t count, const char *name, MethodCallVerifier::CalledCompare comp, std::string *error) const {
+        return std::visit([&](auto &comparator) {
+            if (comparator.compare(static_cast<uint>(count)))
+                return true;
+            if (error) {
+                *error = std::string("Verify error for the ") + name + " of the scope (" + std::to_string(allocations()) +
+                        " allocations, " + std::to_string(bytes()) + " bytes) : " + comparator.expectStr(static_cast<uint>(count));
+                for (const AllocSample &sample : _samples) {
+                    *error += "\n  allocation of " + std::to_string(sample.size) + " bytes";
+#ifdef __GLIBC__
+                    char **symbols = backtrace_symbols(sample.frames.data(), sample.depth);
+                    for (int i = 0; symbols && i < sample.depth; ++i)
+                        *error += std::string("\n    ") + symbols[i];
+                    std::free(symbols);
+#endif
+                }
+            }
+            return false;
+        }, comp);
+    }
+
+} // namespace FSeam
+
+void *operator new(std::size_t size) { return checked(allocate(size)); }
+void *operator new[](std::size_t size) { return checked(allocate(size)); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return checked(allocateAligned(size, alignment)); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return checked(allocateAligned(size, alignment)); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocateAligned(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocateAligned(size, alignment); }
+
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(ptr); }
+
+#ifdef FSEAM_ALLOC_MALLOC_SEAM
+extern "C" {
+
+    void *malloc(std::size_t size) noexcept {
+        FSeam::recordAllocation(size);
+        return __libc_malloc(size);
+    }
+
+    void *calloc(std::size_t count, std::size_t size) noexcept {
+        FSeam::recordAllocation(count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *ptr, std::size_t size) noexcept {
+        if (ptr)
+            FSeam::recordDeallocation();
+        if (size || !ptr)
+            FSeam::recordAllocation(size);
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void *ptr) noexcept {
+        if (ptr)
+            FSeam::recordDeallocation();
+        __libc_free(ptr);
+    }
+
+    void *memalign(std::size_t alignment, std::size_t size) noexcept {
+        FSeam::recordAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    void *aligned_alloc(std::size_t alignment, std::size_t size) noexcept {
+        FSeam::recordAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void **ptr, std::size_t alignment, std::size_t size) noexcept {
+        if (!alignment || (alignment & (alignment - 1)) || alignment % sizeof(void *))
+            return EINVAL;
+        FSeam::recordAllocation(size);
+        void *result = __libc_memalign(alignment, size);
+        if (!result)
+            return ENOMEM;
+        *ptr = result;
+        return 0;
+    }
+
+}
+#endif
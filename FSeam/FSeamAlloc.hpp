@@ -0,0 +1,163 @@
+// MIT License
+//
+// Copyright (c) 2019 Quentin Balland
+// Project : https://github.com/FreeYourSoul/FSeam
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+//
+// Created by FyS on 19/10/26.
+//
+
+#ifndef FREESOULS_FSEAMALLOC_HPP
+#define FREESOULS_FSEAMALLOC_HPP
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "FSeam.hpp"
+
+/**
+ * Allocation counting seam.
+ *
+ * The global operator new / delete (and on glibc malloc, calloc, realloc, free and the aligned allocations) are replaced
+ * at link time by the FSeam-alloc library (addFSeamTests ALLOC_SEAM option). Each allocation is counted on the thread
+ * that makes it, an AllocScope gives the allocations made by its thread during its lifetime and verifies them against
+ * a calling comparator, for example in order to check that a code path doesn't allocate at all :
+ *
+ *     FSeam::AllocScope scope;
+ *     handler.process(request);
+ *     REQUIRE(scope.verifyAllocations(FSeam::AtMost(0)));
+ *
+ * The allocations are forwarded to the default allocator, only the counting is added.
+ */
+#ifndef FSEAM_ALLOC_STACK_DEPTH
+#define FSEAM_ALLOC_STACK_DEPTH 16
+#endif
+
+namespace FSeam {
+
+    struct AllocCounters {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t bytes = 0;
+    };
+
+    /**
+     * @brief Call stack of an allocation made in an AllocScope sampling the stacks
+     */
+    struct AllocSample {
+        std::size_t size = 0;
+        int depth = 0;
+        std::array<void *, FSEAM_ALLOC_STACK_DEPTH> frames {};
+    };
+
+    class AllocScope {
+    public:
+        /**
+         * @brief Allocations made while an Untracked instance is alive (on its thread) are not counted, in order to
+         *        exclude the testing framework (assertions, logging) from a scope
+         */
+        struct Untracked {
+            Untracked();
+            ~Untracked();
+            Untracked(const Untracked &) = delete;
+            Untracked &operator=(const Untracked &) = delete;
+        };
+
+        /**
+         * @param sampledStacks number of allocations of the scope for which the call stack is recorded (the first
+         *        ones), the stacks are printed when a verification fails
+         */
+        explicit AllocScope(std::size_t sampledStacks = 0);
+        ~AllocScope();
+        AllocScope(const AllocScope &) = delete;
+        AllocScope &operator=(const AllocScope &) = delete;
+
+        std::size_t allocations() const;
+        std::size_t deallocations() const;
+        std::size_t bytes() const;
+        const std::vector<AllocSample> &samples() const { return _samples; }
+
+        /**
+         * @return counters of the calling thread since its start
+         */
+        static AllocCounters threadCounters();
+
+        /**
+         * @brief Verify the number of allocations made in the scope
+         *
+         * @tparam Comparator calling comparator (AtMost, AtLeast, NeverCalled, IsNot, VerifyCompare) or integral value
+         * @param verbose flag if a debug string (with the sampled stacks) is required in case of false response
+         * @return true if the number of allocations encounter the provided comparator conditions, false otherwise
+         */
+        template <typename Comparator>
+        bool verifyAllocations(Comparator &&comp, bool verbose = true) const {
+            return verifyCounter(&AllocScope::allocations, "allocations", std::forward<Comparator>(comp), verbose);
+        }
+
+        /**
+         * @brief Verify the number of bytes allocated in the scope, see verifyAllocations
+         */
+        template <typename Comparator>
+        bool verifyBytes(Comparator &&comp, bool verbose = true) const {
+            return verifyCounter(&AllocScope::bytes, "allocated bytes", std::forward<Comparator>(comp), verbose);
+        }
+
+    private:
+        template <typename Comparator>
+        bool verifyCounter(std::size_t (AllocScope::*counter)() const, const char *name, Comparator &&comp, bool verbose) const {
+            if constexpr (std::is_integral<std::decay_t<Comparator>>())
+                return verifyCounter(counter, name, VerifyCompare{ static_cast<uint>(comp) }, verbose);
+            else {
+                static_assert(isCalledComparator<std::decay_t<Comparator>>::v, "Type  should be AtLeast, AtMost, Never, IsNot or VerifyCompare");
+                Untracked untracked;
+                std::string error;
+                bool result = verifyCount((this->*counter)(), name, comp, verbose ? &error : nullptr);
+                // logged from the caller translation unit (the logging depends on the testing framework used)
+                if (!error.empty())
+                    Logging::Logger::log(Logging::Level::ERROR, error);
+                return result;
+            }
+        }
+
+        /**
+         * @param error if not null, set with the reason of the failure and the sampled stacks
+         */
+        bool verifyCount(std::size_t count, const char *name, MethodCallVerifier::CalledCompare comp, std::string *error) const;
+
+        /**
+         * @brief Called by the seam on an allocation of the scope thread
+         */
+        void sample(std::size_t size);
+        friend void recordAllocation(std::size_t size);
+
+        AllocCounters _begin;
+        AllocScope *_parent;
+        std::size_t _sampledStacks;
+        std::vector<AllocSample> _samples;
+    };
+
+    void recordAllocation(std::size_t size);
+    void recordDeallocation();
+
+} // namespace FSeam
+
+#endif //FREESOULS_FSEAMALLOC_HPP
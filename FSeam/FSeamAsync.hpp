@@ -0,0 +1,282 @@
+// MIT License
+//
+// Copyright (c) 2019 Quentin Balland
+// Project : https://github.com/FreeYourSoul/FSeam
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+//
+// Created by FyS on 19/10/26.
+//
+
+#ifndef FREESOULS_FSEAMASYNC_HPP
+#define FREESOULS_FSEAMASYNC_HPP
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "FSeam.hpp"
+
+/**
+ * Asynchronous return values (see MockClassVerifier::dupeAsyncReturn).
+ *
+ * A mocked method returning a std::future, a std::shared_future or an awaitable type with FSeam::AsyncReturn traits
+ * returns a pending result, completed when the test drives the FSeam::AsyncExecutor:
+ *
+ *     fseamMock->dupeAsyncReturn<FSeam::ClassName::functionName>(std::string("value"), std::chrono::milliseconds(5));
+ *     client.sendRequests();
+ *     FSeam::AsyncExecutor::runReverse();
+ */
+namespace FSeam {
+
+    /**
+     * @brief Test controlled executor completing the asynchronous results duped with MockClassVerifier::dupeAsyncReturn
+     * @details Nothing runs on its own: a completion is queued with its due time on the VirtualClock, and is only run (on
+     *          the calling thread) when the test drives the executor, in the order the test chooses. Running a completion
+     *          due later than the current virtual time moves the virtual clock forward to its due time.
+     */
+    class AsyncExecutor {
+    public:
+        using Id = std::size_t;
+
+        /**
+         * @brief Queue a completion due after the given delay (on the virtual clock)
+         * @return identifier of the completion, to be given to run
+         */
+        static Id post(std::function<void()> completion, VirtualClock::duration delay = VirtualClock::duration::zero());
+
+        /**
+         * @return number of completions queued
+         */
+        static std::size_t pending();
+
+        /**
+         * @return identifiers of the queued completions, in posting order
+         */
+        static std::vector<Id> pendingIds();
+
+        /**
+         * @brief Run the given completion whatever its due time
+         * @return false if the completion is not queued (already run)
+         */
+        static bool run(Id id);
+
+        /**
+         * @brief Run the completion due first (posting order between the completions due at the same time)
+         * @return false if no completion is queued
+         */
+        static bool runNext();
+
+        /**
+         * @brief Run the completions in due order until none is queued (including the ones posted meanwhile)
+         * @return number of completions run
+         */
+        static std::size_t runAll();
+
+        /**
+         * @brief Move the virtual clock forward of the given duration, running the completions due meanwhile in due order
+         * @return number of completions run
+         */
+        static std::size_t advance(VirtualClock::duration duration);
+
+        /**
+         * @brief Run the completions queued in the reverse posting order (last request completed first)
+         * @return number of completions run
+         */
+        static std::size_t runReverse();
+
+        /**
+         * @brief Run the completions queued in a random order, deterministic for a given seed
+         * @return number of completions run
+         */
+        static std::size_t runShuffled(std::uint64_t seed);
+
+        /**
+         * @brief Drop the queued completions, called by MockVerifier::reset and cleanUp
+         * @details The completion sources (promises) are released : a std::future or std::shared_future waiting for a
+         *          dropped completion becomes ready and its get throws a std::future_error (broken_promise). A custom
+         *          AsyncReturn type follows the destruction of its Promise.
+         */
+        static void clear();
+
+    private:
+        struct Completion {
+            VirtualClock::duration due;
+            std::function<void()> function;
+        };
+
+        /**
+         * @brief Remove the given completion from the queue and run it (outside of the lock)
+         */
+        static void runAt(std::unique_lock<std::mutex> &lock, std::map<Id, Completion>::iterator it);
+
+        inline static std::mutex _mutex;
+        // completions by identifier (posting order), and their identifiers by due time
+        inline static std::map<Id, Completion> _queue;
+        inline static std::set<std::pair<VirtualClock::duration, Id>> _dueOrder;
+        inline static Id _nextId = 0;
+    };
+
+    /**
+     * @brief Asynchronous return type traits used by dupeAsyncReturn, specialized for std::future and std::shared_future.
+     * @details Another awaitable type (the task type of a coroutine library for instance) is supported by specializing
+     *          the traits with:
+     *          - Promise: default constructible completion source of the awaitable,
+     *          - static Awaitable awaitable(Promise &): awaitable returned by the mocked method,
+     *          - static void complete(Promise &, Value): completion of the awaitable with the duped value.
+     *          The template is registered to the generator (FSEAM_ASYNC_RETURN_TYPES), that doesn't generate a dupeReturn
+     *          specialization copying the awaitable.
+     */
+    template <typename Awaitable>
+    struct AsyncReturn {
+        static constexpr bool IS_ASYNC = false;
+    };
+
+    template <typename T>
+    struct AsyncReturn<std::future<T>> {
+        static constexpr bool IS_ASYNC = true;
+        using Promise = std::promise<T>;
+
+        static std::future<T> awaitable(Promise &promise) { return promise.get_future(); }
+
+        template <typename Value>
+        static void complete(Promise &promise, Value &&value) { promise.set_value(std::forward<Value>(value)); }
+    };
+
+    template <typename T>
+    struct AsyncReturn<std::shared_future<T>> {
+        static constexpr bool IS_ASYNC = true;
+        using Promise = std::promise<T>;
+
+        static std::shared_future<T> awaitable(Promise &promise) { return promise.get_future().share(); }
+
+        template <typename Value>
+        static void complete(Promise &promise, Value &&value) { promise.set_value(std::forward<Value>(value)); }
+    };
+
+    inline AsyncExecutor::Id AsyncExecutor::post(std::function<void()> completion, VirtualClock::duration delay) {
+        // the completions are dropped by MockVerifier::reset and cleanUp
+        MockVerifier::clearCompletions.store(&AsyncExecutor::clear, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(_mutex);
+        VirtualClock::duration due = VirtualClock::elapsed() + std::max(delay, VirtualClock::duration::zero());
+        _queue.emplace(_nextId, Completion{due, std::move(completion)});
+        _dueOrder.emplace(due, _nextId);
+        return _nextId++;
+    }
+
+    inline std::size_t AsyncExecutor::pending() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _queue.size();
+    }
+
+    inline std::vector<AsyncExecutor::Id> AsyncExecutor::pendingIds() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<Id> ids;
+        ids.reserve(_queue.size());
+        for (const auto &[id, completion] : _queue)
+            ids.emplace_back(id);
+        return ids;
+    }
+
+    inline void AsyncExecutor::runAt(std::unique_lock<std::mutex> &lock, std::map<Id, Completion>::iterator it) {
+        Completion completion = std::move(it->second);
+        _dueOrder.erase({completion.due, it->first});
+        _queue.erase(it);
+        lock.unlock();
+        // a completion can post other completions (continuation) or call mocked methods
+        if (completion.due > VirtualClock::elapsed())
+            VirtualClock::advance(completion.due - VirtualClock::elapsed());
+        completion.function();
+    }
+
+    inline bool AsyncExecutor::run(Id id) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto it = _queue.find(id);
+        if (it == _queue.end())
+            return false;
+        runAt(lock, it);
+        return true;
+    }
+
+    inline bool AsyncExecutor::runNext() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_dueOrder.empty())
+            return false;
+        runAt(lock, _queue.find(_dueOrder.begin()->second));
+        return true;
+    }
+
+    inline std::size_t AsyncExecutor::runAll() {
+        std::size_t count = 0;
+        while (runNext())
+            ++count;
+        return count;
+    }
+
+    inline std::size_t AsyncExecutor::advance(VirtualClock::duration duration) {
+        VirtualClock::duration deadline = VirtualClock::elapsed() + duration;
+        std::size_t count = 0;
+        for (;;) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_dueOrder.empty() || _dueOrder.begin()->first > deadline)
+                break;
+            runAt(lock, _queue.find(_dueOrder.begin()->second));
+            ++count;
+        }
+        if (deadline > VirtualClock::elapsed())
+            VirtualClock::advance(deadline - VirtualClock::elapsed());
+        return count;
+    }
+
+    inline std::size_t AsyncExecutor::runReverse() {
+        std::vector<Id> ids = pendingIds();
+        std::size_t count = 0;
+        for (auto it = ids.rbegin(); it != ids.rend(); ++it)
+            count += run(*it);
+        return count;
+    }
+
+    inline std::size_t AsyncExecutor::runShuffled(std::uint64_t seed) {
+        std::vector<Id> ids = pendingIds();
+        std::shuffle(ids.begin(), ids.end(), std::mt19937_64(seed));
+        std::size_t count = 0;
+        for (Id id : ids)
+            count += run(id);
+        return count;
+    }
+
+    inline void AsyncExecutor::clear() {
+        std::map<Id, Completion> dropped;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            dropped.swap(_queue);
+            _dueOrder.clear();
+        }
+        // the promises are released outside of the lock
+    }
+
+} // namespace FSeam
+
+#endif //FREESOULS_FSEAMASYNC_HPP
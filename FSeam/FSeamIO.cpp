@@ -0,0 +1,374 @@
+//
+// Created by FyS on 19/10/26.
+//
+
+// POSIX I/O seam compiled into the FSeam-io library: linking it interposes the libc I/O functions of the test executable,
+// the real functions are found with dlsym(RTLD_NEXT)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <set>
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include "FSeamIO.hpp"
+
+#define FSEAM_IO_REAL(function) \
+    static auto real = reinterpret_cast<decltype(&::function)>(dlsym(RTLD_NEXT, #function))
+
+namespace {
+
+    // never destroyed : the interposed functions can be called by the static destructors
+    struct WatchList {
+        std::mutex mutex;
+        std::set<int> fds;
+        std::set<std::string, std::less<>> paths;
+    };
+
+    WatchList &watchList() {
+        static auto *list = new WatchList();
+        return *list;
+    }
+
+    std::atomic<bool> watching { false };
+
+    std::recursive_mutex &seamMutex() {
+        static auto *mutex = new std::recursive_mutex();
+        return *mutex;
+    }
+
+    bool isWatched(int fd) {
+        if (!watching)
+            return false;
+        WatchList &list = watchList();
+        std::lock_guard<std::mutex> lock(list.mutex);
+        return list.fds.count(fd);
+    }
+
+    bool isWatched(const char *path) {
+        if (!watching || !path)
+            return false;
+        WatchList &list = watchList();
+        std::lock_guard<std::mutex> lock(list.mutex);
+        return list.paths.find(std::string_view(path)) != list.paths.end();
+    }
+
+    /**
+     * @brief invoke the dupes of the function, call the real function (unless handled by a dupe) and record the call
+     */
+    template <typename Real>
+    ssize_t dispatch(std::string_view function, FSeam::IO::CallData &data, Real &&real) {
+        // the thread can be suspended by the interleaving explorer at the schedule point, it must not hold the lock
+        FSeam::SchedulePoint::reach();
+        {
+            std::lock_guard<std::recursive_mutex> lock(seamMutex());
+            FSeam::getFreeFunc()->invokeDupe(function, &data);
+        }
+        // the real call can block (on a pipe filled by another thread for instance), it is made without the lock
+        if (!data.handled) {
+            data.result = real(data);
+            data.error = data.result < 0 ? errno : 0;
+        }
+        {
+            std::lock_guard<std::recursive_mutex> lock(seamMutex());
+            FSeam::getFreeFunc()->methodCall(function, &data);
+        }
+        if (data.result < 0)
+            errno = data.error;
+        return data.result;
+    }
+
+    ssize_t readCall(std::string_view function, int fd, void *buffer, std::size_t count, off_t offset, int flags) {
+        FSeam::IO::CallData data;
+        data.fd = fd;
+        data.buffer = buffer;
+        data.count = count;
+        data.offset = offset;
+        data.flags = flags;
+        data.input = true;
+        return dispatch(function, data, [function](FSeam::IO::CallData &call) -> ssize_t {
+            if (function == "pread") {
+                FSEAM_IO_REAL(pread);
+                return real(call.fd, call.buffer, call.count, call.offset);
+            }
+            if (function == "recv") {
+                FSEAM_IO_REAL(recv);
+                return real(call.fd, call.buffer, call.count, call.flags);
+            }
+            FSEAM_IO_REAL(read);
+            return real(call.fd, call.buffer, call.count);
+        });
+    }
+
+    ssize_t writeCall(std::string_view function, int fd, const void *buffer, std::size_t count, int flags) {
+        FSeam::IO::CallData data;
+        data.fd = fd;
+        data.buffer = const_cast<void *>(buffer);
+        data.count = count;
+        data.flags = flags;
+        return dispatch(function, data, [function](FSeam::IO::CallData &call) -> ssize_t {
+            if (function == "send") {
+                FSEAM_IO_REAL(send);
+                return real(call.fd, call.buffer, call.count, call.flags);
+            }
+            FSEAM_IO_REAL(write);
+            return real(call.fd, call.buffer, call.count);
+        });
+    }
+
+    int openCall(const char *path, int flags, mode_t mode) {
+        FSEAM_IO_REAL(open);
+        if (!isWatched(path))
+            return real(path, flags, mode);
+        FSeam::IO::CallData data;
+        data.path = path;
+        data.flags = flags;
+        return static_cast<int>(dispatch("open", data, [mode](FSeam::IO::CallData &call) -> ssize_t {
+            return real(call.path, call.flags, mode);
+        }));
+    }
+
+    mode_t openMode(int flags, va_list args) {
+#ifdef O_TMPFILE
+        bool withMode = (flags & O_CREAT) || (flags & O_TMPFILE) == O_TMPFILE;
+#else
+        bool withMode = flags & O_CREAT;
+#endif
+        return withMode ? static_cast<mode_t>(va_arg(args, int)) : 0;
+    }
+
+    void *mmapCall(void *address, std::size_t length, int prot, int flags, int fd, off_t offset) {
+        FSEAM_IO_REAL(mmap);
+        if (!isWatched(fd))
+            return real(address, length, prot, flags, fd, offset);
+        FSeam::IO::CallData data;
+        data.fd = fd;
+        data.count = length;
+        data.offset = offset;
+        data.flags = flags;
+        ssize_t result = dispatch("mmap", data, [address, prot](FSeam::IO::CallData &call) -> ssize_t {
+            return reinterpret_cast<std::intptr_t>(real(address, call.count, prot, call.flags, call.fd, call.offset));
+        });
+        // MAP_FAILED is (void *) -1
+        return reinterpret_cast<void *>(static_cast<std::intptr_t>(result));
+    }
+
+}
+
+namespace FSeam::IO {
+
+    void watch(int fd) {
+        WatchList &list = watchList();
+        std::lock_guard<std::mutex> lock(list.mutex);
+        list.fds.insert(fd);
+        watching = true;
+    }
+
+    void watch(std::string path) {
+        WatchList &list = watchList();
+        std::lock_guard<std::mutex> lock(list.mutex);
+        list.paths.insert(std::move(path));
+        watching = true;
+    }
+
+    void unwatch(int fd) {
+        WatchList &list = watchList();
+        std::lock_guard<std::mutex> lock(list.mutex);
+        list.fds.erase(fd);
+    }
+
+    void unwatchAll() {
+        WatchList &list = watchList();
+        std::lock_guard<std::mutex> lock(list.mutex);
+        list.fds.clear();
+        list.paths.clear();
+        watching = false;
+    }
+
+    void apply(const Step &step, CallData &data) {
+        switch (step.kind) {
+            case Step::Kind::PassThrough:
+                break;
+            case Step::Kind::Partial:
+                data.count = std::min(data.count, step.size);
+                break;
+            case Step::Kind::Error:
+                data.handled = true;
+                data.result = -1;
+                data.error = step.error;
+                break;
+            case Step::Kind::Data: {
+                std::size_t size = data.input ? std::min(data.count, step.bytes.size()) : 0;
+                if (size)
+                    std::memcpy(data.buffer, step.bytes.data(), size);
+                data.handled = true;
+                data.result = static_cast<ssize_t>(size);
+                data.error = 0;
+                break;
+            }
+        }
+    }
+
+    void dupeSequence(std::string_view function, int fd, std::vector<Step> steps) {
+        watch(fd);
+        getFreeFunc()->dupeMethod(function, [fd, sequence = std::make_shared<ReturnSequence<Step>>(std::move(steps))](void *arg) {
+            auto *data = static_cast<CallData *>(arg);
+            if (data->fd != fd || data->handled || sequence->_index >= sequence->_values.size())
+                return;
+            apply(sequence->_values[sequence->_index++], *data);
+        }, true);
+    }
+
+    void dupeSequence(std::string_view function, std::string path, std::vector<Step> steps) {
+        watch(path);
+        getFreeFunc()->dupeMethod(function, [path = std::move(path), sequence = std::make_shared<ReturnSequence<Step>>(std::move(steps))](void *arg) {
+            auto *data = static_cast<CallData *>(arg);
+            if (!data->path || path != data->path || data->handled || sequence->_index >= sequence->_values.size())
+                return;
+            apply(sequence->_values[sequence->_index++], *data);
+        }, true);
+    }
+
+} // namespace FSeam::IO
+
+// ------------------------ Interposed libc functions --------------------------
+
+extern "C" {
+
+    ssize_t read(int fd, void *buffer, std::size_t count) {
+        FSEAM_IO_REAL(read);
+        if (!isWatched(fd))
+            return real(fd, buffer, count);
+        return readCall("read", fd, buffer, count, 0, 0);
+    }
+
+    ssize_t pread(int fd, void *buffer, std::size_t count, off_t offset) {
+        FSEAM_IO_REAL(pread);
+        if (!isWatched(fd))
+            return real(fd, buffer, count, offset);
+        return readCall("pread", fd, buffer, count, offset, 0);
+    }
+
+    ssize_t recv(int fd, void *buffer, std::size_t count, int flags) {
+        FSEAM_IO_REAL(recv);
+        if (!isWatched(fd))
+            return real(fd, buffer, count, flags);
+        return readCall("recv", fd, buffer, count, 0, flags);
+    }
+
+    ssize_t write(int fd, const void *buffer, std::size_t count) {
+        FSEAM_IO_REAL(write);
+        if (!isWatched(fd))
+            return real(fd, buffer, count);
+        return writeCall("write", fd, buffer, count, 0);
+    }
+
+    ssize_t send(int fd, const void *buffer, std::size_t count, int flags) {
+        FSEAM_IO_REAL(send);
+        if (!isWatched(fd))
+            return real(fd, buffer, count, flags);
+        return writeCall("send", fd, buffer, count, flags);
+    }
+
+    ssize_t writev(int fd, const struct iovec *iov, int iovcnt) {
+        FSEAM_IO_REAL(writev);
+        if (!isWatched(fd))
+            return real(fd, iov, iovcnt);
+        FSeam::IO::CallData data;
+        data.fd = fd;
+        data.buffer = const_cast<struct iovec *>(iov);
+        for (int i = 0; i < iovcnt; ++i)
+            data.count += iov[i].iov_len;
+        return dispatch("writev", data, [iovcnt](FSeam::IO::CallData &call) -> ssize_t {
+            // the vector is truncated to the (possibly lowered) count of bytes
+            std::vector<struct iovec> vector(static_cast<const struct iovec *>(call.buffer),
+                                             static_cast<const struct iovec *>(call.buffer) + iovcnt);
+            std::size_t remaining = call.count;
+            std::size_t used = 0;
+            for (; used < vector.size() && remaining; ++used) {
+                vector[used].iov_len = std::min(vector[used].iov_len, remaining);
+                remaining -= vector[used].iov_len;
+            }
+            return real(call.fd, vector.data(), static_cast<int>(used));
+        });
+    }
+
+    int open(const char *path, int flags, ...) {
+        va_list args;
+        va_start(args, flags);
+        mode_t mode = openMode(flags, args);
+        va_end(args);
+        return openCall(path, flags, mode);
+    }
+
+    void *mmap(void *address, std::size_t length, int prot, int flags, int fd, off_t offset) noexcept {
+        return mmapCall(address, length, prot, flags, fd, offset);
+    }
+
+    // not dispatched to the mock : the file descriptor stops being watched, its number can be reused by the next open
+    int close(int fd) {
+        FSEAM_IO_REAL(close);
+        if (isWatched(fd))
+            FSeam::IO::unwatch(fd);
+        return real(fd);
+    }
+
+    int fsync(int fd) {
+        FSEAM_IO_REAL(fsync);
+        if (!isWatched(fd))
+            return real(fd);
+        FSeam::IO::CallData data;
+        data.fd = fd;
+        return static_cast<int>(dispatch("fsync", data, [](FSeam::IO::CallData &call) -> ssize_t {
+            return real(call.fd);
+        }));
+    }
+
+#if defined(__GLIBC__) && defined(__LP64__) && defined(__USE_LARGEFILE64)
+    // large file variants (_FILE_OFFSET_BITS=64), the same functions on 64 bits
+    int open64(const char *path, int flags, ...) {
+        va_list args;
+        va_start(args, flags);
+        mode_t mode = openMode(flags, args);
+        va_end(args);
+        return openCall(path, flags, mode);
+    }
+
+    ssize_t pread64(int fd, void *buffer, std::size_t count, off64_t offset) {
+        return pread(fd, buffer, count, offset);
+    }
+
+    void *mmap64(void *address, std::size_t length, int prot, int flags, int fd, off64_t offset) noexcept {
+        return mmapCall(address, length, prot, flags, fd, offset);
+    }
+#endif
+
+#ifdef __linux__
+    int epoll_wait(int fd, struct epoll_event *events, int maxEvents, int timeout) {
+        FSEAM_IO_REAL(epoll_wait);
+        if (!isWatched(fd))
+            return real(fd, events, maxEvents, timeout);
+        FSeam::IO::CallData data;
+        data.fd = fd;
+        data.buffer = events;
+        data.count = static_cast<std::size_t>(std::max(maxEvents, 0));
+        return static_cast<int>(dispatch("epoll_wait", data, [timeout](FSeam::IO::CallData &call) -> ssize_t {
+            return real(call.fd, static_cast<struct epoll_event *>(call.buffer), static_cast<int>(call.count), timeout);
+        }));
+    }
+#endif
+
+}
@@ -0,0 +1,179 @@
+// MIT License
+//
+// Copyright (c) 2019 Quentin Balland
+// Project : https://github.com/FreeYourSoul/FSeam
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+//
+// Created by FyS on 19/10/26.
+//
+
+#ifndef FREESOULS_FSEAMIO_HPP
+#define FREESOULS_FSEAMIO_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "FSeam.hpp"
+
+/**
+ * POSIX I/O seam.
+ *
+ * The FSeam-io library (addFSeamTests IO_SEAM option) interposes the libc functions read, pread, recv, write, writev,
+ * send, open, mmap, fsync and epoll_wait. A call on a watched file descriptor (or an open of a watched path) goes through
+ * the free function mock (FSeam::getFreeFunc()) under the name of the libc function : it is recorded (verify) and the
+ * dupes registered on it are invoked with a FSeam::IO::CallData. The real function is then called, unless a dupe
+ * handled the call. The calls on the other file descriptors go straight to the libc. close is interposed as well, it
+ * unwatches the file descriptor (see unwatch).
+ *
+ * The helpers below register such dupes in order to script the kernel backpressure deterministically : partial reads,
+ * short writes, errors (EAGAIN, EINTR...) and latency on the FSeam::VirtualClock.
+ *
+ *     FSeam::IO::dupeSequence("read", socket, {FSeam::IO::Partial(3), FSeam::IO::Error(EAGAIN)});
+ *     FSeam::IO::dupeLatency("write", socket, FSeam::Latency::Fixed(std::chrono::milliseconds(2)));
+ *     ...
+ *     REQUIRE(FSeam::getFreeFunc()->verify("read", 2));
+ */
+namespace FSeam::IO {
+
+    /**
+     * @brief Data of an interposed call given to the dupes (the method call data structure of the seam)
+     */
+    struct CallData {
+        int fd = -1;
+        const char *path = nullptr;
+        int flags = 0;
+        /**
+         * buffer read into (read, pread, recv), written (write, send), iovec array (writev) or events (epoll_wait)
+         */
+        void *buffer = nullptr;
+        /**
+         * bytes to transfer (number of events for epoll_wait, length for mmap), can be lowered by a dupe
+         */
+        std::size_t count = 0;
+        off_t offset = 0;
+        bool input = false;
+
+        /**
+         * set by a dupe when the real function must not be called, result and error are then returned
+         */
+        bool handled = false;
+        ssize_t result = 0;
+        int error = 0;
+    };
+
+    /**
+     * @brief Scripted outcome of one call (see dupeSequence)
+     */
+    struct Step {
+        enum class Kind { PassThrough, Partial, Error, Data };
+
+        explicit Step(Kind kind = Kind::PassThrough, std::size_t size = 0, int error = 0, std::string bytes = {}) :
+            kind(kind), size(size), error(error), bytes(std::move(bytes)) {}
+
+        Kind kind;
+        std::size_t size;
+        int error;
+        std::string bytes;
+    };
+
+    /**
+     * @brief the call goes to the real function
+     */
+    inline Step PassThrough() { return Step(); }
+
+    /**
+     * @brief the real function is called with at most maxBytes bytes (at most maxBytes events for epoll_wait) : partial
+     *        read, short write
+     */
+    inline Step Partial(std::size_t maxBytes) { return Step(Step::Kind::Partial, maxBytes); }
+
+    /**
+     * @brief the call fails with the given errno (EAGAIN, EINTR, EIO...) without calling the real function
+     */
+    inline Step Error(int error) { return Step(Step::Kind::Error, 0, error); }
+
+    /**
+     * @brief a read returns the given bytes (at most the requested count) without reading the file descriptor,
+     *        an empty string simulates the end of file (any other call returns 0 without calling the real function)
+     */
+    inline Step Data(std::string bytes) { return Step(Step::Kind::Data, 0, 0, std::move(bytes)); }
+
+    /**
+     * @brief calls on the file descriptor (open of the path) go through the free function mock, in order to be verified
+     */
+    void watch(int fd);
+    void watch(std::string path);
+
+    /**
+     * @brief stop watching the file descriptor, done by the interposed close : a number reused by a later open (pipe,
+     *        socket...) isn't routed through the mock
+     * @note a file descriptor closed inside the libc (fclose) isn't seen by the seam, it has to be unwatched explicitly
+     */
+    void unwatch(int fd);
+
+    /**
+     * @brief stop watching all the file descriptors and paths (the dupes are removed by MockVerifier::cleanUp)
+     */
+    void unwatchAll();
+
+    /**
+     * @brief Apply the given steps to the successive calls of the function on the file descriptor, the calls go to the
+     *        real function once the sequence is over
+     * @note The duping is done in a composed way, several file descriptors can be scripted on the same function
+     *
+     * @param function name of the interposed libc function ("read", "write", "epoll_wait"...)
+     * @param fd file descriptor scripted (watched)
+     * @param steps outcome of each call
+     */
+    void dupeSequence(std::string_view function, int fd, std::vector<Step> steps);
+
+    /**
+     * @brief Same as above on the open calls of the given path
+     */
+    void dupeSequence(std::string_view function, std::string path, std::vector<Step> steps);
+
+    /**
+     * @brief Apply the given step to the data of a call (used by dupeSequence)
+     */
+    void apply(const Step &step, CallData &data);
+
+    /**
+     * @brief Dupe the time spent into the function on the file descriptor, each call sleeps on the FSeam::VirtualClock
+     *        for a duration taken from the provided distribution (see MockClassVerifier::dupeLatency)
+     * @note The duping is done in a composed way, calling dupeLatency won't override current dupe
+     */
+    template <typename Distribution>
+    void dupeLatency(std::string_view function, int fd, Distribution distribution) {
+        watch(fd);
+        getFreeFunc()->dupeMethod(function, [fd, dist = std::make_shared<Distribution>(std::move(distribution))](void *arg) {
+            if (static_cast<CallData *>(arg)->fd == fd)
+                VirtualClock::sleepFor(dist->next());
+        }, true);
+    }
+
+} // namespace FSeam::IO
+
+#endif //FREESOULS_FSEAMIO_HPP
@@ -0,0 +1,432 @@
+// MIT License
+//
+// Copyright (c) 2019 Quentin Balland
+// Project : https://github.com/FreeYourSoul/FSeam
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+//
+// Created by FyS on 10/19/26.
+//
+
+#ifndef FREESOULS_MOCKVERIFIER_IMPL_HH
+#define FREESOULS_MOCKVERIFIER_IMPL_HH
+
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "FSeam.hpp"
+
+/**
+ * Definition of the non-template part of FSeam, compiled into the FSeam-static library (FSeam.cpp), or included by
+ * FSeam.hpp when FSEAM_HEADER_ONLY is defined (FSEAM_INLINE is then inline)
+ */
+namespace FSeam {
+
+    // ------------------------ Logging --------------------------
+
+    FSEAM_INLINE std::function<void(Logging::Level, const std::string &)> &Logging::Logger::custom(
+            std::optional<std::function<void(Level, const std::string &)> > logging) {
+
+        static std::function<void(Level, const std::string &)> customLogger = logging.value_or(&Logger::print);
+        customEnabled = true;
+        return customLogger;
+    }
+
+    FSEAM_INLINE void Logging::Logger::print(Level level, const std::string &msg) {
+        if (level == Level::ERROR)
+            std::cerr << msg << "\n";
+        else
+            std::cout << msg << "\n";
+    }
+
+    // ------------------------ VirtualClock --------------------------
+
+    FSEAM_INLINE void VirtualClock::sleepFor(duration d) {
+        if (d <= duration::zero())
+            return;
+        if (_realTime)
+            std::this_thread::sleep_for(d);
+        advance(d);
+    }
+
+    // ------------------------ CaptureArena --------------------------
+
+    namespace internal {
+        // lock of the CaptureArena blocks, defined here in order to keep <mutex> out of FSeam.hpp
+        FSEAM_INLINE std::mutex captureArenaMutex;
+    }
+
+    FSEAM_INLINE std::vector<std::pair<std::unique_ptr<std::max_align_t[]>, std::size_t>> CaptureArena::_blocks;
+    FSEAM_INLINE std::size_t CaptureArena::_current = 0;
+    FSEAM_INLINE std::size_t CaptureArena::_used = 0;
+
+    FSEAM_INLINE void *CaptureArena::allocate(std::size_t size) {
+        std::lock_guard<std::mutex> lock(internal::captureArenaMutex);
+        size = (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+        if (_blocks.empty() || _used + size > _blocks[_current].second) {
+            // next block big enough (kept by a rewind), allocated if none
+            std::size_t next = _blocks.empty() ? 0 : _current + 1;
+            while (next < _blocks.size() && _blocks[next].second < size)
+                ++next;
+            if (next == _blocks.size()) {
+                std::size_t blockSize = std::max(BLOCK_SIZE, size);
+                _blocks.emplace_back(std::make_unique<std::max_align_t[]>(blockSize / sizeof(std::max_align_t)), blockSize);
+            }
+            _current = next;
+            _used = 0;
+        }
+        void *memory = reinterpret_cast<std::byte *>(_blocks[_current].first.get()) + _used;
+        _used += size;
+        return memory;
+    }
+
+    FSEAM_INLINE void CaptureArena::reset() {
+        std::lock_guard<std::mutex> lock(internal::captureArenaMutex);
+        _blocks.clear();
+        _current = 0;
+        _used = 0;
+    }
+
+    FSEAM_INLINE void CaptureArena::rewind() {
+        std::lock_guard<std::mutex> lock(internal::captureArenaMutex);
+        _current = 0;
+        _used = 0;
+    }
+
+    // ------------------------ SharedRegistry --------------------------
+
+    FSEAM_INLINE bool SharedRegistry::create(std::size_t slotCount, std::size_t recordCount) {
+        static bool atForkRegistered = false;
+
+        release();
+        slotCount = std::max<std::size_t>(slotCount, 1);
+        recordCount = std::max<std::size_t>(recordCount, 1);
+        std::size_t size = sizeof(Segment) + slotCount * sizeof(Slot) + recordCount * sizeof(Record);
+        void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+            return false;
+        _segment = new (memory) Segment{size, slotCount, recordCount, {0}, {0}, {false}};
+        for (std::size_t i = 0; i < slotCount; ++i)
+            new (&slots()[i]) Slot{{0}, {0}};
+        for (std::size_t i = 0; i < recordCount; ++i)
+            new (&ring()[i]) Record{{0}, {0}, {0}, {0}};
+        ++_generation;
+        _pid = getpid();
+        if (!atForkRegistered)
+            atForkRegistered = !pthread_atfork(nullptr, nullptr, []() { _pid = getpid(); });
+        return true;
+    }
+
+    FSEAM_INLINE void SharedRegistry::release() {
+        if (_segment)
+            munmap(_segment, _segment->size);
+        _segment = nullptr;
+    }
+
+    FSEAM_INLINE SharedRegistry::Slot *SharedRegistry::slot(std::uint64_t key, bool insert, bool *inserted) {
+        if (!_segment)
+            return nullptr;
+        Slot *table = slots();
+        std::size_t count = _segment->slotCount;
+        for (std::size_t i = 0, index = key % count; i < count; ++i, index = (index + 1) % count) {
+            std::uint64_t current = table[index].key.load(std::memory_order_acquire);
+            if (current == 0) {
+                if (!insert)
+                    return nullptr;
+                // inserted by another process in the meantime : current is set to its key
+                if (table[index].key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                    if (inserted)
+                        *inserted = true;
+                    return &table[index];
+                }
+            }
+            if (current == key)
+                return &table[index];
+        }
+        if (insert)
+            _segment->full.store(true, std::memory_order_release);
+        return nullptr;
+    }
+
+    FSEAM_INLINE void SharedRegistry::record(std::uint64_t key) {
+        std::uint64_t index = _segment->head.fetch_add(1, std::memory_order_relaxed);
+        Record &record = ring()[index % _segment->recordCount];
+        record.sequence.store(0, std::memory_order_relaxed);
+        record.key.store(key, std::memory_order_relaxed);
+        record.pid.store(_pid.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        record.elapsed.store(VirtualClock::elapsed().count(), std::memory_order_relaxed);
+        record.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    FSEAM_INLINE std::vector<SharedCall> SharedRegistry::records(std::uint64_t key) {
+        std::vector<SharedCall> calls;
+        if (!_segment)
+            return calls;
+        std::uint64_t head = _segment->head.load(std::memory_order_acquire);
+        std::uint64_t count = _segment->recordCount;
+        std::uint64_t first = std::max(_segment->floor.load(), head > count ? head - count : 0);
+        for (std::uint64_t index = first; index < head; ++index) {
+            Record &record = ring()[index % count];
+            // not written yet, or overwritten by a more recent call
+            if (record.sequence.load(std::memory_order_acquire) != index + 1 || record.key.load(std::memory_order_relaxed) != key)
+                continue;
+            calls.emplace_back(SharedCall{record.pid.load(std::memory_order_relaxed),
+                                          VirtualClock::duration(record.elapsed.load(std::memory_order_relaxed)), index});
+        }
+        return calls;
+    }
+
+    FSEAM_INLINE void SharedRegistry::clearRecords() {
+        if (_segment)
+            _segment->floor = _segment->head.load();
+    }
+
+    // ------------------------ MockClassVerifier --------------------------
+
+    FSEAM_INLINE void MockClassVerifier::invokeDupedMethod(std::string_view methodName, void *arg) {
+        SchedulePoint::reach();
+        invokeDupe(methodName, arg);
+    }
+
+    FSEAM_INLINE void MockClassVerifier::invokeDupe(std::string_view methodName, void *arg) {
+        if (auto it = _verifiers.find(methodName); it != _verifiers.end()) {
+            if (auto &dupedMethod = it->second->_handler; dupedMethod)
+                dupedMethod(arg);
+        }
+    }
+
+    FSEAM_INLINE void MockClassVerifier::methodCall(std::string_view methodName, void *data) {
+        auto &methodCallVerifier = getMethodCallVerifier(methodName);
+
+        for (auto &expectation : methodCallVerifier->_expectations)
+            expectation.check(data);
+        if (methodCallVerifier->_columns)
+            methodCallVerifier->_columns->append(data);
+        for (auto &probe : methodCallVerifier->_indexProbes)
+            probe(data);
+        methodCallVerifier->_called += 1;
+        if (SharedRegistry::active()) {
+            std::size_t counted = 1;
+            if (methodCallVerifier->_sharedGeneration != SharedRegistry::generation()) {
+                bool inserted = false;
+                methodCallVerifier->_sharedKey = SharedRegistry::key(_sharedId, methodName);
+                methodCallVerifier->_sharedSlot = SharedRegistry::slot(methodCallVerifier->_sharedKey, true, &inserted);
+                methodCallVerifier->_sharedGeneration = SharedRegistry::generation();
+                // the calls made before the registry was shared (inherited by the forked processes) are counted once,
+                // by the process inserting the slot
+                if (inserted)
+                    counted = methodCallVerifier->_called;
+            }
+            if (methodCallVerifier->_sharedSlot)
+                methodCallVerifier->_sharedSlot->count.fetch_add(counted, std::memory_order_relaxed);
+            SharedRegistry::record(methodCallVerifier->_sharedKey);
+        }
+    }
+
+    FSEAM_INLINE void MockClassVerifier::clearExpectations(std::optional<std::string_view> methodName) {
+        if (methodName) {
+            if (auto it = _verifiers.find(*methodName); it != _verifiers.end()) {
+                std::shared_ptr<MethodCallVerifier> &methodCallVerifier = it->second;
+                methodCallVerifier->_expectations.clear();
+                methodCallVerifier->_deferredExpectations.clear();
+                methodCallVerifier->_indexedExpectations.clear();
+                methodCallVerifier->_columns.reset();
+                methodCallVerifier->_indexProbes.clear();
+                methodCallVerifier->_resetHandlers.clear();
+            }
+        }
+        else {
+            for( auto const& [key, val] : _verifiers) {
+                val->_expectations.clear();
+                val->_deferredExpectations.clear();
+                val->_indexedExpectations.clear();
+                val->_columns.reset();
+                val->_indexProbes.clear();
+                val->_resetHandlers.clear();
+            }
+        }
+    }
+
+    FSEAM_INLINE void MockClassVerifier::reset() {
+        for (auto &[methodName, methodCallVerifier] : _verifiers) {
+            methodCallVerifier->_called = 0;
+            for (auto &expectation : methodCallVerifier->_expectations)
+                expectation._numberTimeMatched = 0;
+            if (methodCallVerifier->_columns)
+                methodCallVerifier->_columns->clear();
+            for (auto &resetHandler : methodCallVerifier->_resetHandlers)
+                resetHandler();
+            for (auto &resetHandler : methodCallVerifier->_dupeResetHandlers)
+                resetHandler();
+            if (auto *slot = SharedRegistry::slot(SharedRegistry::key(_sharedId, methodName), false); slot)
+                slot->count = 0;
+        }
+    }
+
+    FSEAM_INLINE std::vector<SharedCall> MockClassVerifier::sharedCalls(std::string_view methodName) const {
+        return SharedRegistry::records(SharedRegistry::key(_sharedId, methodName));
+    }
+
+    FSEAM_INLINE void MockClassVerifier::registerExpectation(std::string_view methodName, MethodCallVerifier::Expectation expectation) {
+        getMethodCallVerifier(methodName)->_expectations.emplace_back(std::move(expectation));
+    }
+
+    FSEAM_INLINE void MockClassVerifier::dupeMethod(std::string_view methodName, const std::function<void(void*)> &handler, bool isComposed) {
+        auto &methodCallVerifier = getMethodCallVerifier(methodName);
+
+        if (isComposed && methodCallVerifier->_handler) {
+            methodCallVerifier->_handler = [currentHandler = methodCallVerifier->_handler, handler](void *data){
+                currentHandler(data);
+                handler(data);
+            };
+        }
+        else {
+            methodCallVerifier->_called = 0;
+            methodCallVerifier->_handler = handler;
+            // the state of the overridden handler (token bucket of a rate limit for instance) is not reset anymore
+            methodCallVerifier->_dupeResetHandlers.clear();
+        }
+    }
+
+    FSEAM_INLINE bool MockClassVerifier::verifyCalls(std::string_view methodName, MethodCallVerifier::CalledCompare comp, std::string *error) const {
+        auto it = _verifiers.find(methodName);
+        // calls made by all the processes sharing the registry
+        std::optional<std::size_t> shared;
+        if (SharedRegistry::active()) {
+            if (auto *slot = SharedRegistry::slot(SharedRegistry::key(_sharedId, methodName), false); slot)
+                shared = slot->count.load(std::memory_order_acquire);
+            else if (SharedRegistry::full()) {
+                // the calls of the method made by the other processes may not have been counted
+                if (error)
+                    *error = "Verify error for method " + _className + std::string(methodName) +
+                            ", the shared registry is full: its calls aren't counted across the processes (increase the" +
+                            " slots given to MockVerifier::shareAcrossProcesses) \n";
+                return false;
+            }
+            // not called since the registry is shared : the calls made before are only counted locally
+        }
+
+        return std::visit([this, it, methodName, error, shared](auto &c) {
+            if (it == _verifiers.end() && !shared.value_or(0)) {
+                if (error && c._toCompare > 0u)
+                    *error = "Verify error for method " + _className + std::string(methodName) +
+                            ", method never have been called while " + c.expectStr(0u) + " method call \n";
+                return c._toCompare == 0u;
+            }
+            std::size_t called = shared ? *shared : it->second->_called;
+            bool result = c.compare(called);
+            if (error && !result)
+                *error = "Verify error for method " + _className + std::string(methodName) + ", method has been called but " +
+                        c.expectStr(called) + " method call \n";
+            if (it == _verifiers.end())
+                return result;
+            MethodCallVerifier &methodCallVerifier = *it->second;
+            for (auto &expect : methodCallVerifier._expectations)
+                result &= expect();
+            for (auto &expect : methodCallVerifier._deferredExpectations)
+                result &= expect();
+            for (auto &expect : methodCallVerifier._indexedExpectations)
+                result &= expect();
+            return result;
+        }, comp);
+    }
+
+    FSEAM_INLINE std::shared_ptr<MethodCallVerifier> &MockClassVerifier::getMethodCallVerifier(std::string_view methodName) {
+        auto it = _verifiers.find(methodName);
+
+        if (it == _verifiers.end()) {
+            it = _verifiers.emplace(std::string(methodName), std::make_shared<MethodCallVerifier>()).first;
+            it->second->_methodName = it->first;
+        }
+        return it->second;
+    }
+
+    // ------------------------ MockVerifier --------------------------
+
+    FSEAM_INLINE std::unique_ptr<MockVerifier> MockVerifier::inst = nullptr;
+
+    FSEAM_INLINE MockVerifier &MockVerifier::instance() {
+        if (inst == nullptr) {
+            inst = std::make_unique<MockVerifier>();
+        };
+        return *(inst.get());
+    }
+
+    FSEAM_INLINE void MockVerifier::cleanUp() {
+        inst.reset(nullptr);
+        if (auto clear = clearCompletions.load(std::memory_order_acquire); clear)
+            clear();
+        VirtualClock::reset();
+        CaptureArena::reset();
+        SharedRegistry::release();
+    }
+
+    FSEAM_INLINE void MockVerifier::reset() {
+        if (auto clear = clearCompletions.load(std::memory_order_acquire); clear)
+            clear();
+        // rewound first, the reset handlers restart from the origin of the virtual clock
+        VirtualClock::rewind();
+        CaptureArena::rewind();
+        SharedRegistry::clearRecords();
+        if (inst == nullptr)
+            return;
+        for (auto &[mockPtr, mock] : inst->_mockedClass)
+            mock->reset();
+        for (auto &[className, mock] : inst->_defaultMockedClass)
+            mock->reset();
+    }
+
+    FSEAM_INLINE bool MockVerifier::shareAcrossProcesses(std::size_t slots, std::size_t records) {
+        return SharedRegistry::create(slots, records);
+    }
+
+    FSEAM_INLINE bool MockVerifier::isMockRegistered(const void *mockPtr) {
+        return this->_mockedClass.find(mockPtr) != this->_mockedClass.end();
+    }
+
+    FSEAM_INLINE std::shared_ptr<MockClassVerifier> &MockVerifier::getMock(const void *mockPtr, std::string_view classMockName) {
+        if (!isMockRegistered(mockPtr))
+            return addMock(mockPtr, classMockName);
+        return this->_mockedClass.at(mockPtr);
+    }
+
+    FSEAM_INLINE std::shared_ptr<MockClassVerifier> &MockVerifier::getDefaultMock(std::string_view classMockName) {
+        if (auto it = this->_defaultMockedClass.find(classMockName); it != this->_defaultMockedClass.end())
+            return it->second;
+        return addDefaultMock(classMockName);
+    }
+
+    FSEAM_INLINE std::shared_ptr<MockClassVerifier> &MockVerifier::addMock(const void *mockPtr, std::string_view className) {
+        this->_mockedClass[mockPtr] = std::make_shared<MockClassVerifier>(std::string(className), SharedRegistry::mockId(className, mockPtr));
+        return this->_mockedClass.at(mockPtr);
+    }
+
+    FSEAM_INLINE std::shared_ptr<MockClassVerifier> &MockVerifier::addDefaultMock(std::string_view className) {
+        return this->_defaultMockedClass.emplace(className,
+                std::make_shared<MockClassVerifier>(std::string(className), SharedRegistry::mockId(className))).first->second;
+    }
+
+}
+
+#endif //FREESOULS_MOCKVERIFIER_IMPL_HH
@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2019 Quentin Balland
+// Project : https://github.com/FreeYourSoul/FSeam
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+//
+// Created by FyS on 19/10/26.
+//
+
+#ifndef FREESOULS_FSEAMLATENCY_HPP
+#define FREESOULS_FSEAMLATENCY_HPP
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "FSeam.hpp"
+
+namespace FSeam {
+
+    /**
+     * @brief Latency distributions used in order to dupe the time spent in a mocked method (see MockClassVerifier::dupeLatency)
+     * @note Each distribution is deterministic for a given seed, so a failing test can always be replayed
+     */
+    namespace Latency {
+
+        struct Fixed {
+            explicit Fixed(VirtualClock::duration delay) : _delay(delay) {}
+            VirtualClock::duration next() { return _delay; }
+
+            VirtualClock::duration _delay;
+        };
+
+        struct Uniform {
+            Uniform(VirtualClock::duration min, VirtualClock::duration max, std::uint64_t seed = 0) :
+                _engine(seed), _distribution(min.count(), max.count()) {}
+            VirtualClock::duration next() { return VirtualClock::duration(_distribution(_engine)); }
+
+            std::mt19937_64 _engine;
+            std::uniform_int_distribution<VirtualClock::duration::rep> _distribution;
+        };
+
+        /**
+         * @brief Latency taken from a recorded histogram, each bucket is a pair of delay and weight (number of occurrence
+         *        of that delay in the recording for example)
+         */
+        struct Histogram {
+            explicit Histogram(std::vector<std::pair<VirtualClock::duration, double> > buckets, std::uint64_t seed = 0) : _engine(seed) {
+                std::vector<double> weights;
+                for (auto &[delay, weight] : buckets) {
+                    _delays.emplace_back(delay);
+                    weights.emplace_back(weight);
+                }
+                _distribution = std::discrete_distribution<std::size_t>(weights.begin(), weights.end());
+            }
+            VirtualClock::duration next() {
+                return _delays.empty() ? VirtualClock::duration::zero() : _delays.at(_distribution(_engine));
+            }
+
+            std::mt19937_64 _engine;
+            std::discrete_distribution<std::size_t> _distribution;
+            std::vector<VirtualClock::duration> _delays;
+        };
+
+        /**
+         * @brief Token bucket used in order to throttle a mocked method (see MockClassVerifier::dupeRateLimit)
+         * @details The bucket starts full with capacity tokens, a token is given back every refillPeriod of VirtualClock time.
+         */
+        struct TokenBucket {
+            TokenBucket(std::size_t capacity, VirtualClock::duration refillPeriod) :
+                _capacity(capacity), _tokens(capacity), _refillPeriod(refillPeriod), _lastRefill(VirtualClock::elapsed()) {}
+
+            bool tryAcquire() {
+                refill();
+                if (!_tokens)
+                    return false;
+                --_tokens;
+                return true;
+            }
+
+            /**
+             * @return duration to wait until the next token is available (zero if a token is already available)
+             */
+            VirtualClock::duration timeToNextToken() {
+                refill();
+                if (_tokens || _refillPeriod <= VirtualClock::duration::zero())
+                    return VirtualClock::duration::zero();
+                return _refillPeriod - (VirtualClock::elapsed() - _lastRefill);
+            }
+
+            void refill() {
+                VirtualClock::duration now = VirtualClock::elapsed();
+                if (_refillPeriod <= VirtualClock::duration::zero() || now < _lastRefill)
+                    return;
+                auto refilled = static_cast<std::size_t>((now - _lastRefill) / _refillPeriod);
+                _tokens = std::min(_capacity, _tokens + refilled);
+                _lastRefill += _refillPeriod * refilled;
+            }
+
+            std::size_t _capacity;
+            std::size_t _tokens;
+            VirtualClock::duration _refillPeriod;
+            VirtualClock::duration _lastRefill;
+        };
+
+    }
+
+} // namespace FSeam
+
+#endif //FREESOULS_FSEAMLATENCY_HPP
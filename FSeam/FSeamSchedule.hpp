@@ -0,0 +1,431 @@
+// MIT License
+//
+// Copyright (c) 2019 Quentin Balland
+// Project : https://github.com/FreeYourSoul/FSeam
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+//
+// Created by FyS on 19/10/26.
+//
+
+#ifndef FREESOULS_FSEAMSCHEDULE_HPP
+#define FREESOULS_FSEAMSCHEDULE_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FSeam.hpp"
+
+/**
+ * Deterministic interleaving explorer.
+ *
+ * The threads spawned through a FSeam::Schedule::Run are controlled: only one of them runs at a time, and the running
+ * thread can only be switched at a schedule point, which is any mocked call (or an explicit FSeam::Schedule::yield()).
+ * At each schedule point, the strategy chooses the next thread to run. The test body is run once per schedule:
+ *
+ *     auto result = FSeam::Schedule::explore({}, [](FSeam::Schedule::Run &run) {
+ *         WorkQueue queue;
+ *         run.spawn([&queue] { queue.push(1); });
+ *         run.spawn([&queue] { queue.steal(); });
+ *         run.join();
+ *         return queue.invariant();
+ *     });
+ *     REQUIRE_FALSE(result.failed);   // result.schedule (or result.seed and result.steps) replays the failing run
+ *
+ * Strategies :
+ *   PCT        : probabilistic concurrency testing, random priorities given to the threads, the highest priority thread
+ *                runs, and its priority is lowered at depth - 1 random steps. Each run is seeded by seed + run index.
+ *   Exhaustive : depth first enumeration of all the schedules switching away from a runnable thread at most
+ *                preemptions times.
+ *
+ * The controlled threads must not block on anything else than schedule points (a lock held by a suspended thread
+ * would never be released). A spinning thread is eventually run round robin with the others after maxSteps steps.
+ */
+namespace FSeam::Schedule {
+
+    enum class Strategy {
+        PCT,
+        Exhaustive
+    };
+
+    struct Options {
+        Strategy strategy = Strategy::PCT;
+        // number of runs (maximum number of runs for Exhaustive)
+        std::size_t runs = 1000;
+        // PCT : seed of the first run
+        std::uint64_t seed = 0;
+        // PCT : bug depth, number of ordering constraints to hit (depth - 1 priority change points)
+        std::size_t depth = 3;
+        // PCT : number of schedule points among which the change points are taken, 0 to use the longest run so far
+        std::size_t steps = 0;
+        // Exhaustive : maximum number of preemptions of a schedule
+        std::size_t preemptions = 2;
+        // schedule points of a run after which the threads are run round robin
+        std::size_t maxSteps = 10000;
+        // schedule to replay (Result::schedule), a single run is done
+        std::string replay;
+        bool stopOnFailure = true;
+    };
+
+    struct Result {
+        bool failed = false;
+        std::size_t runs = 0;
+        // Exhaustive : all the schedules within the preemption bound have been run
+        bool exhausted = false;
+        // PCT seed of the (first) failing run
+        std::uint64_t seed = 0;
+        // PCT steps of the (first) failing run, the run is reproduced with the same seed and steps options
+        std::size_t steps = 0;
+        // thread chosen at each schedule point of the (first) failing run, to be given to Options::replay
+        std::string schedule;
+    };
+
+    namespace internal {
+
+        constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+        /**
+         * @brief Strategy state kept across the runs of an exploration
+         */
+        class Explorer {
+        public:
+            explicit Explorer(const Options &options) : _options(options) {
+                std::size_t begin = 0;
+                while (begin < options.replay.size()) {
+                    std::size_t end = options.replay.find('.', begin);
+                    end = end == std::string::npos ? options.replay.size() : end;
+                    _replay.emplace_back(std::stoul(options.replay.substr(begin, end - begin)));
+                    begin = end + 1;
+                }
+            }
+
+            /**
+             * @return false if there is no schedule left to run (Exhaustive)
+             */
+            bool begin(std::size_t run) {
+                _seed = _options.seed + run;
+                _choices.clear();
+                _step = 0;
+                _preemptions = 0;
+                _depth = 0;
+                _priorities.clear();
+                if (_options.strategy == Strategy::Exhaustive && run > 0 && !nextExhaustive())
+                    return false;
+                if (_options.strategy == Strategy::PCT) {
+                    _engine.seed(_seed);
+                    // change points taken among the steps of the longest run so far (unless given)
+                    _steps = std::max<std::size_t>(_options.steps ? _options.steps : _estimatedSteps, 1);
+                    std::uniform_int_distribution<std::size_t> step(1, _steps);
+                    _changePoints.clear();
+                    for (std::size_t i = 1; i < _options.depth; ++i)
+                        _changePoints.emplace_back(step(_engine));
+                }
+                return true;
+            }
+
+            void end() {
+                _estimatedSteps = std::max(_estimatedSteps, _step);
+            }
+
+            std::size_t choose(const std::vector<std::size_t> &runnable, std::size_t current, std::size_t threadCount) {
+                bool currentRunnable = std::find(runnable.begin(), runnable.end(), current) != runnable.end();
+                std::size_t chosen = currentRunnable ? current : runnable.front();
+
+                ++_step;
+                if (!_replay.empty()) {
+                    if (_choices.size() < _replay.size() &&
+                        std::find(runnable.begin(), runnable.end(), _replay[_choices.size()]) != runnable.end())
+                        chosen = _replay[_choices.size()];
+                }
+                else if (_step > _options.maxSteps) {
+                    // round robin, in order to let a spinning thread progress
+                    auto next = std::upper_bound(runnable.begin(), runnable.end(), current);
+                    chosen = next == runnable.end() ? runnable.front() : *next;
+                }
+                else if (_options.strategy == Strategy::PCT)
+                    chosen = choosePCT(runnable, current, currentRunnable, threadCount);
+                else
+                    chosen = chooseExhaustive(runnable, current, currentRunnable, chosen);
+                _choices.emplace_back(chosen);
+                return chosen;
+            }
+
+            std::string schedule() const {
+                std::string schedule;
+                for (std::size_t choice : _choices)
+                    schedule += (schedule.empty() ? "" : ".") + std::to_string(choice);
+                return schedule;
+            }
+
+            std::uint64_t seed() const { return _seed; }
+
+            std::size_t steps() const { return _steps; }
+
+            bool isReplay() const { return !_replay.empty(); }
+
+        private:
+            struct Decision {
+                std::vector<std::size_t> alternatives;
+                std::size_t position;
+                std::size_t current;
+                bool currentRunnable;
+                // preemptions of the schedule before this decision
+                std::size_t preemptions;
+
+                bool preempts(std::size_t position) const {
+                    return currentRunnable && alternatives[position] != current;
+                }
+            };
+
+            std::size_t choosePCT(const std::vector<std::size_t> &runnable, std::size_t current, bool currentRunnable, std::size_t threadCount) {
+                if (_priorities.empty()) {
+                    // distinct priorities above the depth, the change points lower the priority under all of them
+                    for (std::size_t i = 0; i < threadCount; ++i)
+                        _priorities.emplace_back(_options.depth + i);
+                    std::shuffle(_priorities.begin(), _priorities.end(), _engine);
+                }
+                for (std::size_t i = 0; i < _changePoints.size(); ++i) {
+                    if (_changePoints[i] == _step && currentRunnable)
+                        _priorities[current] = _options.depth - 1 - i;
+                }
+                return *std::max_element(runnable.begin(), runnable.end(), [this](std::size_t lhs, std::size_t rhs) {
+                    return _priorities[lhs] < _priorities[rhs];
+                });
+            }
+
+            std::size_t chooseExhaustive(const std::vector<std::size_t> &runnable, std::size_t current, bool currentRunnable, std::size_t defaultChoice) {
+                if (_depth == _decisions.size()) {
+                    // new decision, the default choice (no preemption) explored first
+                    Decision decision {{defaultChoice}, 0, current, currentRunnable, _preemptions};
+                    for (std::size_t thread : runnable) {
+                        if (thread != defaultChoice)
+                            decision.alternatives.emplace_back(thread);
+                    }
+                    _decisions.emplace_back(std::move(decision));
+                }
+                const Decision &decision = _decisions[_depth++];
+                _preemptions = decision.preemptions + decision.preempts(decision.position);
+                return decision.alternatives[decision.position];
+            }
+
+            /**
+             * @brief Backtrack to the last decision having an alternative within the preemption bound
+             */
+            bool nextExhaustive() {
+                while (!_decisions.empty()) {
+                    Decision &decision = _decisions.back();
+                    while (++decision.position < decision.alternatives.size()) {
+                        if (decision.preemptions + decision.preempts(decision.position) <= _options.preemptions)
+                            return true;
+                    }
+                    _decisions.pop_back();
+                }
+                return false;
+            }
+
+            const Options &_options;
+            std::vector<std::size_t> _replay;
+            std::vector<std::size_t> _choices;
+            std::size_t _step = 0;
+            std::uint64_t _seed = 0;
+
+            // PCT
+            std::mt19937_64 _engine;
+            std::vector<std::size_t> _priorities;
+            std::vector<std::size_t> _changePoints;
+            std::size_t _estimatedSteps = 0;
+            std::size_t _steps = 0;
+
+            // Exhaustive
+            std::vector<Decision> _decisions;
+            std::size_t _depth = 0;
+            std::size_t _preemptions = 0;
+        };
+
+    }
+
+    /**
+     * @brief Threads of a run of the test body, controlled by the strategy
+     */
+    class Run {
+    public:
+        explicit Run(internal::Explorer &explorer) : _explorer(explorer) {}
+
+        ~Run() {
+            join();
+        }
+
+        Run(const Run &) = delete;
+        Run &operator=(const Run &) = delete;
+
+        /**
+         * @brief Start a controlled thread, suspended until join is called
+         */
+        void spawn(std::function<void()> function) {
+            auto thread = std::make_unique<Thread>();
+            thread->function = std::move(function);
+            thread->thread = std::thread(&Run::threadMain, this, _threads.size());
+            _threads.emplace_back(std::move(thread));
+        }
+
+        /**
+         * @brief Run the spawned threads under the strategy until they all end
+         */
+        void join() {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (!_started && !_threads.empty()) {
+                    _started = true;
+                    _current = choose();
+                    _condition.notify_all();
+                }
+                _condition.wait(lock, [this]() { return _finished == _threads.size(); });
+            }
+            for (auto &thread : _threads) {
+                if (thread->thread.joinable())
+                    thread->thread.join();
+            }
+        }
+
+        /**
+         * @brief Schedule point of the calling controlled thread : the strategy chooses the next thread to run
+         */
+        void yield(std::size_t index) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            std::size_t next = choose();
+            if (next == index)
+                return;
+            _current = next;
+            _condition.notify_all();
+            _condition.wait(lock, [this, index]() { return _current == index; });
+        }
+
+        inline static thread_local Run *current = nullptr;
+        inline static thread_local std::size_t currentIndex = internal::NONE;
+
+    private:
+        struct Thread {
+            std::function<void()> function;
+            std::thread thread;
+            bool finished = false;
+        };
+
+        void threadMain(std::size_t index) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this, index]() { return _current == index; });
+            }
+            current = this;
+            currentIndex = index;
+            _threads[index]->function();
+            current = nullptr;
+            currentIndex = internal::NONE;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _threads[index]->finished = true;
+            ++_finished;
+            _current = choose();
+            _condition.notify_all();
+        }
+
+        /**
+         * @note called with the lock held
+         */
+        std::size_t choose() {
+            std::vector<std::size_t> runnable;
+            for (std::size_t i = 0; i < _threads.size(); ++i) {
+                if (!_threads[i]->finished)
+                    runnable.emplace_back(i);
+            }
+            if (runnable.empty())
+                return internal::NONE;
+            return _explorer.choose(runnable, _current, _threads.size());
+        }
+
+        internal::Explorer &_explorer;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::vector<std::unique_ptr<Thread>> _threads;
+        std::size_t _current = internal::NONE;
+        std::size_t _finished = 0;
+        bool _started = false;
+    };
+
+    /**
+     * @brief Explicit schedule point (a spin loop of the tested code for instance), no effect outside a controlled thread
+     */
+    inline void yield() {
+        if (Run::current)
+            Run::current->yield(Run::currentIndex);
+    }
+
+    /**
+     * @brief Run the test body under different interleavings of the threads it spawns
+     *
+     * @param options strategy and number of runs, or schedule to replay
+     * @param body spawns the threads of the test, joins them (Run::join) and returns false if the run failed
+     * @return result of the exploration, with the schedule of the first failing run
+     */
+    inline Result explore(const Options &options, const std::function<bool(Run &)> &body) {
+        internal::Explorer explorer(options);
+        Result result;
+        std::size_t runs = explorer.isReplay() ? 1 : options.runs;
+
+        // reset even if the body throws, the mocked calls must not reach a finished explorer
+        struct HookGuard {
+            HookGuard() { SchedulePoint::hook = &Schedule::yield; }
+            ~HookGuard() { SchedulePoint::hook = nullptr; }
+        } guard;
+        for (std::size_t run = 0; run < runs; ++run) {
+            if (!explorer.begin(run)) {
+                result.exhausted = true;
+                break;
+            }
+            bool passed;
+            {
+                Run controlled(explorer);
+                passed = body(controlled);
+                controlled.join();
+            }
+            explorer.end();
+            ++result.runs;
+            if (!passed && !result.failed) {
+                result.failed = true;
+                result.seed = explorer.seed();
+                result.steps = explorer.steps();
+                result.schedule = explorer.schedule();
+            }
+            if (result.failed && options.stopOnFailure)
+                break;
+        }
+        return result;
+    }
+
+} // namespace FSeam::Schedule
+
+#endif //FREESOULS_FSEAMSCHEDULE_HPP
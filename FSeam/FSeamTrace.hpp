@@ -0,0 +1,704 @@
+// MIT License
+//
+// Copyright (c) 2019 Quentin Balland
+// Project : https://github.com/FreeYourSoul/FSeam
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+//
+// Created by FyS on 19/10/26.
+//
+
+#ifndef FREESOULS_FSEAMTRACE_HPP
+#define FREESOULS_FSEAMTRACE_HPP
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "FSeam.hpp"
+
+/**
+ * Record and replay of mocked calls.
+ *
+ * The calls of a mocked method (arguments and return value) are recorded into a compact binary trace file while the tests
+ * run against a stub implementation (any dupe). The trace can then be replayed: the return values are read from the
+ * (memory mapped) file and the arguments are cross-checked against the recorded ones.
+ * There is no call-through: the real implementation of a mocked method is replaced by the mock, the recorded return
+ * values are the ones set by the dupes registered before the recorder (a dupe forwarding the calls to a stand-in object
+ * for instance).
+ *
+ * The same trace can be used as a call history: FSeam::Trace::CallHistory scans the (memory mapped) trace lazily in order
+ * to answer verify queries after the fact, without keeping the calls in memory.
+ *
+ * Trace file format (native endianness), append only:
+ *   FileHeader   : magic "FSEAMTRC", version
+ *   Record*      : RecordHeader (method id, virtual clock timestamp, payload size) followed by the payload
+ *                  payload of a call record : encoded arguments followed by the encoded return value (if any)
+ */
+namespace FSeam::Trace {
+
+    constexpr char MAGIC[8] = {'F', 'S', 'E', 'A', 'M', 'T', 'R', 'C'};
+    constexpr std::uint32_t VERSION = 1;
+
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    struct RecordHeader {
+        std::uint64_t methodId;
+        std::int64_t timestamp;
+        std::uint32_t payloadSize;
+        std::uint32_t reserved;
+    };
+
+    /**
+     * @brief FNV-1a hash, used in order to identify a method in the trace
+     */
+    constexpr std::uint64_t hash(std::string_view str, std::uint64_t h = 14695981039346656037ull) {
+        for (char c : str) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    /**
+     * @return identifier of the method in the trace, hash of "ClassName::methodName" (names given by the FSeam generated
+     *         identifier structure), the same with any compiler
+     */
+    template <typename ClassMethodIdentifier>
+    constexpr std::uint64_t methodId() {
+        return hash(ClassMethodIdentifier::NAME, hash("::", hash(ClassMethodIdentifier::CLASS_NAME)));
+    }
+
+    /**
+     * @brief Buffer in which a record payload is encoded
+     */
+    class Encoder {
+    public:
+        void write(const void *data, std::size_t size) {
+            auto *bytes = static_cast<const char *>(data);
+            _buffer.insert(_buffer.end(), bytes, bytes + size);
+        }
+        const std::vector<char> &buffer() const { return _buffer; }
+        void clear() { _buffer.clear(); }
+
+    private:
+        std::vector<char> _buffer;
+    };
+
+    /**
+     * @brief Cursor on a record payload (memory mapped), decoding fails gracefully if the payload is too short
+     */
+    class Decoder {
+    public:
+        Decoder(const char *begin, std::size_t size) : _cursor(begin), _end(begin + size) {}
+
+        bool read(void *data, std::size_t size) {
+            if (static_cast<std::size_t>(_end - _cursor) < size) {
+                _cursor = _end;
+                _failed = true;
+                return false;
+            }
+            std::memcpy(data, _cursor, size);
+            _cursor += size;
+            return true;
+        }
+        bool failed() const { return _failed; }
+
+    private:
+        const char *_cursor;
+        const char *_end;
+        bool _failed = false;
+    };
+
+    /**
+     * @brief Encoding of a type into the trace, specialize this structure in order to record custom types.
+     *        A specialization provides:
+     *          static void encode(Encoder &, const T &);
+     *          static T decode(Decoder &);
+     *        Trivially copyable types, std::string, std::optional and std::vector are supported out of the box.
+     *        Pointers are not recorded (their value is meaningless from a run to another), they are not cross-checked.
+     */
+    template <typename T, typename Enable = void>
+    struct Codec {
+        static_assert(std::is_trivially_copyable<T>(), "No FSeam::Trace::Codec specialization for this type");
+
+        static void encode(Encoder &encoder, const T &value) { encoder.write(&value, sizeof(T)); }
+        static T decode(Decoder &decoder) {
+            T value;
+            decoder.read(&value, sizeof(T));
+            return value;
+        }
+    };
+
+    template <typename T>
+    struct Codec<T *> {
+        static void encode(Encoder &, T *) {}
+        static T *decode(Decoder &) { return nullptr; }
+    };
+
+    template <>
+    struct Codec<std::string> {
+        static void encode(Encoder &encoder, const std::string &value) {
+            auto size = static_cast<std::uint32_t>(value.size());
+            encoder.write(&size, sizeof(size));
+            encoder.write(value.data(), value.size());
+        }
+        static std::string decode(Decoder &decoder) {
+            std::uint32_t size = 0;
+            decoder.read(&size, sizeof(size));
+            std::string value(size, '\0');
+            decoder.read(value.data(), size);
+            return value;
+        }
+    };
+
+    template <typename T>
+    struct Codec<std::vector<T> > {
+        static void encode(Encoder &encoder, const std::vector<T> &value) {
+            auto size = static_cast<std::uint32_t>(value.size());
+            encoder.write(&size, sizeof(size));
+            for (const auto &v : value)
+                Codec<T>::encode(encoder, v);
+        }
+        static std::vector<T> decode(Decoder &decoder) {
+            std::uint32_t size = 0;
+            decoder.read(&size, sizeof(size));
+            std::vector<T> value;
+            for (std::uint32_t i = 0; i < size && !decoder.failed(); ++i)
+                value.emplace_back(Codec<T>::decode(decoder));
+            return value;
+        }
+    };
+
+    template <typename T>
+    struct Codec<std::optional<T> > {
+        static void encode(Encoder &encoder, const std::optional<T> &value) {
+            auto isSet = static_cast<std::uint8_t>(value.has_value());
+            encoder.write(&isSet, sizeof(isSet));
+            if (value)
+                Codec<T>::encode(encoder, *value);
+        }
+        static std::optional<T> decode(Decoder &decoder) {
+            std::uint8_t isSet = 0;
+            decoder.read(&isSet, sizeof(isSet));
+            if (!isSet)
+                return std::nullopt;
+            return Codec<T>::decode(decoder);
+        }
+    };
+
+    namespace internal {
+        /**
+         * @brief type of an argument as captured in the method call data structure (reference are captured as reference_wrapper)
+         */
+        template <typename T> struct captured { using type = T; };
+        template <typename T> struct captured<std::reference_wrapper<T> > { using type = std::remove_const_t<T>; };
+
+        template <typename T>
+        void encodeArg(Encoder &encoder, const std::optional<T> &arg) {
+            using Captured = typename captured<T>::type;
+            auto isSet = static_cast<std::uint8_t>(arg.has_value());
+            encoder.write(&isSet, sizeof(isSet));
+            if (arg)
+                Codec<Captured>::encode(encoder, FSeam::internal::unwrap(*arg));
+        }
+
+        /**
+         * @brief decode an argument encoded by encodeArg
+         */
+        template <typename T>
+        std::optional<typename captured<T>::type> decodeArg(Decoder &decoder) {
+            std::uint8_t isSet = 0;
+            decoder.read(&isSet, sizeof(isSet));
+            if (!isSet)
+                return std::nullopt;
+            return Codec<typename captured<T>::type>::decode(decoder);
+        }
+
+        template <typename T> struct argsOf;
+        template <typename ...Ts> struct argsOf<std::tuple<std::optional<Ts> &...> > {
+            using type = std::tuple<std::optional<typename captured<Ts>::type>...>;
+
+            static type decode(Decoder &decoder) { return type{decodeArg<Ts>(decoder)...}; }
+        };
+        template <> struct argsOf<std::tuple<> > {
+            using type = std::tuple<>;
+
+            static type decode(Decoder &) { return type{}; }
+        };
+
+        /**
+         * @brief decoded arguments of a recorded call of the method ClassMethodIdentifier (tuple of optional argument)
+         */
+        template <typename ClassMethodIdentifier>
+        using DecodedArgs = argsOf<decltype(ClassMethodIdentifier::args(nullptr))>;
+
+        /**
+         * @return true if the argument captured match the recorded one (or if it cannot be compared)
+         */
+        template <typename T>
+        bool matchArg(Decoder &decoder, const std::optional<T> &arg) {
+            using Captured = typename captured<T>::type;
+            std::uint8_t isSet = 0;
+            decoder.read(&isSet, sizeof(isSet));
+            if (!isSet)
+                return !arg.has_value();
+            Captured recorded = Codec<Captured>::decode(decoder);
+            if constexpr (std::is_pointer<Captured>() || !comparator::internal::has_equality<Captured>())
+                return true;
+            else
+                return arg.has_value() && FSeam::internal::unwrap(*arg) == recorded;
+        }
+    }
+
+    /**
+     * @brief Buffered append only writer of a trace file
+     */
+    class TraceWriter {
+    public:
+        explicit TraceWriter(const std::string &path, std::size_t bufferSize = 1 << 16) : _bufferSize(bufferSize) {
+            _file = std::fopen(path.c_str(), "wb");
+            if (!_file) {
+                Logging::Logger::log(Logging::Level::ERROR, "FSeam trace: cannot open " + path + " for writing");
+                return;
+            }
+            FileHeader header {};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            std::fwrite(&header, sizeof(header), 1, _file);
+            _buffer.reserve(bufferSize);
+        }
+        ~TraceWriter() { close(); }
+
+        TraceWriter(const TraceWriter &) = delete;
+        TraceWriter &operator=(const TraceWriter &) = delete;
+
+        void append(std::uint64_t methodId, std::int64_t timestamp, const std::vector<char> &payload) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_file)
+                return;
+            RecordHeader header {methodId, timestamp, static_cast<std::uint32_t>(payload.size()), 0};
+            auto *headerBytes = reinterpret_cast<const char *>(&header);
+            _buffer.insert(_buffer.end(), headerBytes, headerBytes + sizeof(header));
+            _buffer.insert(_buffer.end(), payload.begin(), payload.end());
+            if (_buffer.size() >= _bufferSize)
+                flushBuffer();
+        }
+
+        void flush() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_file) {
+                flushBuffer();
+                std::fflush(_file);
+            }
+        }
+
+        void close() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_file) {
+                flushBuffer();
+                std::fclose(_file);
+                _file = nullptr;
+            }
+        }
+
+    private:
+        void flushBuffer() {
+            if (!_buffer.empty())
+                std::fwrite(_buffer.data(), 1, _buffer.size(), _file);
+            _buffer.clear();
+        }
+
+    private:
+        std::FILE *_file = nullptr;
+        std::size_t _bufferSize;
+        std::vector<char> _buffer;
+        std::mutex _mutex;
+    };
+
+    /**
+     * @brief Read only memory mapped view on a trace file, records are decoded lazily
+     */
+    class MappedTrace {
+    public:
+        struct Record {
+            std::uint64_t methodId;
+            std::int64_t timestamp;
+            const char *payload;
+            std::uint32_t payloadSize;
+        };
+
+        explicit MappedTrace(const std::string &path) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            struct stat st {};
+            if (fd < 0 || ::fstat(fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+                Logging::Logger::log(Logging::Level::ERROR, "FSeam trace: cannot open trace file " + path);
+                if (fd >= 0)
+                    ::close(fd);
+                return;
+            }
+            void *mapped = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mapped == MAP_FAILED) {
+                Logging::Logger::log(Logging::Level::ERROR, "FSeam trace: cannot map trace file " + path);
+                return;
+            }
+            auto *header = static_cast<const FileHeader *>(mapped);
+            if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION) {
+                Logging::Logger::log(Logging::Level::ERROR, "FSeam trace: " + path + " is not a FSeam trace file");
+                ::munmap(mapped, st.st_size);
+                return;
+            }
+            _data = static_cast<const char *>(mapped);
+            _size = st.st_size;
+        }
+        ~MappedTrace() {
+            if (_data)
+                ::munmap(const_cast<char *>(_data), _size);
+        }
+
+        MappedTrace(const MappedTrace &) = delete;
+        MappedTrace &operator=(const MappedTrace &) = delete;
+
+        bool isValid() const { return _data != nullptr; }
+
+        /**
+         * @brief Call the visitor on each record of the trace (in order), stop if the visitor return false
+         */
+        template <typename Visitor>
+        void forEach(Visitor &&visitor) const {
+            std::size_t offset = sizeof(FileHeader);
+            while (_data && offset + sizeof(RecordHeader) <= _size) {
+                RecordHeader header;
+                std::memcpy(&header, _data + offset, sizeof(header));
+                offset += sizeof(header);
+                if (offset + header.payloadSize > _size)
+                    break;
+                if (!visitor(Record{header.methodId, header.timestamp, _data + offset, header.payloadSize}))
+                    break;
+                offset += header.payloadSize;
+            }
+        }
+
+    private:
+        const char *_data = nullptr;
+        std::size_t _size = 0;
+    };
+
+    /**
+     * @brief Record the calls of mocked methods into a trace file
+     *
+     * @example
+     * @code
+     * FSeam::Trace::Recorder recorder("checkSimpleReturnValue.trace");
+     * fseamMock->dupeReturn<FSeam::DependencyGettable::checkSimpleReturnValue>(42); // stub implementation
+     * recorder.record<FSeam::DependencyGettable::checkSimpleReturnValue>(fseamMock);
+     * // ... run the test
+     * recorder.close();
+     * @endcode
+     */
+    class Recorder {
+    public:
+        explicit Recorder(const std::string &path) : _writer(std::make_shared<TraceWriter>(path)) {}
+
+        /**
+         * @brief Record the calls of the given method of the mock
+         * @note The recording is done in a composed way, as the handlers are called in registration order the recording
+         *       has to be set after the stubbing dupes (dupeReturn, dupeMethod...) in order to record their return value
+         */
+        template <typename ClassMethodIdentifier>
+        void record(const std::shared_ptr<MockClassVerifier> &mock) {
+            mock->dupeMethod(ClassMethodIdentifier::NAME, [writer = _writer](void *data) {
+                thread_local Encoder encoder;
+                encoder.clear();
+                std::apply([](const auto &... args) { (internal::encodeArg(encoder, args), ...); },
+                        ClassMethodIdentifier::args(data));
+                if constexpr (hasReturnValue<ClassMethodIdentifier>(0)) {
+                    const auto &returnValue = ClassMethodIdentifier::returnValue(data);
+                    Codec<std::decay_t<decltype(returnValue)> >::encode(encoder, returnValue);
+                }
+                writer->append(methodId<ClassMethodIdentifier>(), VirtualClock::now().time_since_epoch().count(), encoder.buffer());
+            }, true);
+        }
+
+        void flush() { _writer->flush(); }
+        void close() { _writer->close(); }
+
+        template <typename ClassMethodIdentifier>
+        static constexpr auto hasReturnValue(int) -> decltype(ClassMethodIdentifier::returnValue(nullptr), bool()) { return true; }
+        template <typename ClassMethodIdentifier>
+        static constexpr bool hasReturnValue(...) { return false; }
+
+    private:
+        std::shared_ptr<TraceWriter> _writer;
+    };
+
+    /**
+     * @brief Replay a trace file recorded by a FSeam::Trace::Recorder: the return values of the replayed methods are taken
+     *        from the trace (in the recorded order), and the arguments are cross-checked with the recorded ones.
+     *
+     * @example
+     * @code
+     * FSeam::Trace::Replayer replayer("checkSimpleReturnValue.trace");
+     * replayer.replay<FSeam::DependencyGettable::checkSimpleReturnValue>(fseamMock);
+     * // ... run the test
+     * REQUIRE(replayer.verify());
+     * @endcode
+     */
+    class Replayer {
+        struct State {
+            explicit State(const std::string &path) : trace(path) {}
+
+            MappedTrace trace;
+            std::unordered_map<std::uint64_t, std::vector<MappedTrace::Record> > records;
+            std::unordered_map<std::uint64_t, std::size_t> cursors;
+            std::size_t mismatches = 0;
+            std::size_t exhausted = 0;
+            std::mutex mutex;
+        };
+
+    public:
+        explicit Replayer(const std::string &path) : _state(std::make_shared<State>(path)) {
+            _state->trace.forEach([this](const MappedTrace::Record &record) {
+                _state->records[record.methodId].emplace_back(record);
+                return true;
+            });
+        }
+
+        bool isValid() const { return _state->trace.isValid(); }
+
+        /**
+         * @brief Replay the recorded calls of the given method on the mock
+         * @note The duping is done in a composed way, calling replay won't override current dupe
+         */
+        template <typename ClassMethodIdentifier>
+        void replay(const std::shared_ptr<MockClassVerifier> &mock) {
+            _state->cursors[methodId<ClassMethodIdentifier>()] = 0;
+            mock->dupeMethod(ClassMethodIdentifier::NAME, [state = _state](void *data) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                auto id = methodId<ClassMethodIdentifier>();
+                auto &records = state->records[id];
+                auto &cursor = state->cursors[id];
+                if (cursor >= records.size()) {
+                    ++state->exhausted;
+                    Logging::Logger::log(Logging::Level::ERROR, "FSeam trace: no more recorded call to replay for method " +
+                            std::string(ClassMethodIdentifier::NAME));
+                    return;
+                }
+                const auto &record = records[cursor++];
+                Decoder decoder(record.payload, record.payloadSize);
+                bool match = true;
+                std::apply([&decoder, &match](const auto &... args) {
+                    ((match &= internal::matchArg(decoder, args)), ...);
+                }, ClassMethodIdentifier::args(data));
+                if constexpr (Recorder::hasReturnValue<ClassMethodIdentifier>(0)) {
+                    auto &returnValue = ClassMethodIdentifier::returnValue(data);
+                    returnValue = Codec<std::decay_t<decltype(returnValue)> >::decode(decoder);
+                }
+                if (!match || decoder.failed()) {
+                    ++state->mismatches;
+                    Logging::Logger::log(Logging::Level::ERROR, "FSeam trace: arguments of call " + std::to_string(cursor) +
+                            " of method " + std::string(ClassMethodIdentifier::NAME) + " differ from the recorded ones");
+                }
+            }, true);
+        }
+
+        /**
+         * @return number of calls for which the arguments didn't match the recorded ones
+         */
+        std::size_t mismatches() const { return _state->mismatches; }
+
+        /**
+         * @brief Verify the replay: no argument mismatch, no call made after the end of the recording, and if complete is
+         *        set, every recorded call of the replayed methods has been consumed
+         */
+        bool verify(bool complete = true, bool verbose = true) const {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            bool result = _state->mismatches == 0 && _state->exhausted == 0;
+            if (complete) {
+                for (auto &[id, cursor] : _state->cursors) {
+                    if (cursor < _state->records[id].size()) {
+                        result = false;
+                        if (verbose)
+                            Logging::Logger::log(Logging::Level::ERROR, "FSeam trace: " +
+                                    std::to_string(_state->records[id].size() - cursor) + " recorded calls have not been replayed");
+                    }
+                }
+            }
+            return result;
+        }
+
+    private:
+        std::shared_ptr<State> _state;
+    };
+
+    /**
+     * @brief Lazy view on the call history recorded into a trace file by a FSeam::Trace::Recorder
+     * @details The trace is memory mapped and scanned at each query, recorded calls are decoded on the fly: long running
+     *          tests can record huge histories without keeping them in memory and check them after the fact.
+     *
+     * @example
+     * @code
+     * FSeam::Trace::CallHistory history("dependency.trace");
+     * REQUIRE(history.verify<FSeam::DependencyGettable::checkSimpleInputVariable>(FSeam::AtLeast{2}));
+     * REQUIRE(history.verifyArg<FSeam::DependencyGettable::checkSimpleInputVariable>(FSeam::Eq(42), FSeam::Any(), 1));
+     * REQUIRE(history.calledBefore<FSeam::DependencyGettable::checkCalled, FSeam::DependencyGettable::checkSimpleReturnValue>());
+     * @endcode
+     */
+    class CallHistory {
+    public:
+        explicit CallHistory(const std::string &path) : _trace(path) {}
+
+        bool isValid() const { return _trace.isValid(); }
+
+        /**
+         * @brief Call the visitor on each recorded call of the method (in order) with the decoded arguments (tuple of
+         *        std::optional of each argument) and the virtual clock timestamp of the call. Stop if the visitor return false.
+         */
+        template <typename ClassMethodIdentifier, typename Visitor>
+        void forEachCall(Visitor &&visitor) const {
+            auto id = methodId<ClassMethodIdentifier>();
+            _trace.forEach([id, &visitor](const MappedTrace::Record &record) {
+                if (record.methodId != id)
+                    return true;
+                Decoder decoder(record.payload, record.payloadSize);
+                auto args = internal::DecodedArgs<ClassMethodIdentifier>::decode(decoder);
+                return static_cast<bool>(visitor(args, VirtualClock::duration(record.timestamp)));
+            });
+        }
+
+        /**
+         * @return number of recorded calls of the method
+         */
+        template <typename ClassMethodIdentifier>
+        std::size_t count() const {
+            std::size_t number = 0;
+            auto id = methodId<ClassMethodIdentifier>();
+            _trace.forEach([id, &number](const MappedTrace::Record &record) {
+                number += record.methodId == id;
+                return true;
+            });
+            return number;
+        }
+
+        /**
+         * @return number of recorded calls of the method for which the predicate (taking the decoded arguments tuple) is true
+         */
+        template <typename ClassMethodIdentifier, typename Predicate>
+        std::size_t countIf(Predicate &&predicate) const {
+            std::size_t number = 0;
+            forEachCall<ClassMethodIdentifier>([&number, &predicate](const auto &args, VirtualClock::duration) {
+                number += static_cast<bool>(predicate(args));
+                return true;
+            });
+            return number;
+        }
+
+        /**
+         * @brief Verify the number of recorded calls of the method
+         * @param comp calling comparator (or integral value for an exact number of calls)
+         */
+        template <typename ClassMethodIdentifier, typename Comparator>
+        bool verify(Comparator &&comp, bool verbose = true) const {
+            return checkCount<ClassMethodIdentifier>(count<ClassMethodIdentifier>(), std::forward<Comparator>(comp), verbose);
+        }
+
+        /**
+         * @brief Verify the number of recorded calls of the method matching the argument comparators (FSeam::Eq, FSeam::NotEq,
+         *        FSeam::Any, FSeam::CustomComparator)
+         * @param verifiers one argument comparator per argument, optionally followed by a calling comparator (AtLeast{1} by default)
+         */
+        template <typename ClassMethodIdentifier, typename ...Verifiers>
+        bool verifyArg(Verifiers ... verifiers) const {
+            using Args = typename internal::DecodedArgs<ClassMethodIdentifier>::type;
+            constexpr std::size_t argsNumber = std::tuple_size<Args>::value;
+            static_assert(sizeof...(Verifiers) == argsNumber || sizeof...(Verifiers) == argsNumber + 1,
+                    "verifyArg takes one argument comparator per argument and optionally a calling comparator");
+            auto all = std::make_tuple(verifiers...);
+            std::size_t matched = countIf<ClassMethodIdentifier>([&all](const Args &args) {
+                return matchAll(all, args, std::make_index_sequence<argsNumber>());
+            });
+            if constexpr (sizeof...(Verifiers) == argsNumber)
+                return checkCount<ClassMethodIdentifier>(matched, AtLeast{1}, true);
+            else
+                return checkCount<ClassMethodIdentifier>(matched, std::get<argsNumber>(all), true);
+        }
+
+        /**
+         * @return true if the first recorded call of MethodFirst happened before the first recorded call of MethodSecond
+         *         (false if one of those methods has never been called)
+         */
+        template <typename MethodFirst, typename MethodSecond>
+        bool calledBefore() const {
+            auto first = methodId<MethodFirst>();
+            auto second = methodId<MethodSecond>();
+            bool result = false;
+            _trace.forEach([first, second, &result](const MappedTrace::Record &record) {
+                if (record.methodId == second)
+                    return false;
+                if (record.methodId == first) {
+                    result = true;
+                    return false;
+                }
+                return true;
+            });
+            return result && count<MethodSecond>() > 0;
+        }
+
+    private:
+        template <typename Verifiers, typename Args, std::size_t ...I>
+        static bool matchAll(const Verifiers &verifiers, const Args &args, std::index_sequence<I...>) {
+            return ((std::get<I>(args) && std::get<I>(verifiers).template compare<
+                    typename std::decay_t<decltype(std::get<I>(args))>::value_type>(*std::get<I>(args))) && ... && true);
+        }
+
+        template <typename ClassMethodIdentifier, typename Comparator>
+        bool checkCount(std::size_t number, Comparator comp, bool verbose) const {
+            if constexpr (std::is_integral<Comparator>())
+                return checkCount<ClassMethodIdentifier>(number, VerifyCompare{static_cast<uint>(comp)}, verbose);
+            else {
+                static_assert(isCalledComparator<Comparator>::v, "Type  should be AtLeast, AtMost, Never, IsNot or VerifyCompare");
+                bool result = comp.compare(static_cast<uint>(number));
+                if (verbose && !result) {
+                    Logging::Logger::log(Logging::Level::ERROR, "Verify error on call history for method " +
+                            std::string(ClassMethodIdentifier::NAME) + ", " + comp.expectStr(static_cast<uint>(number)) + " method call \n");
+                }
+                return result;
+            }
+        }
+
+    private:
+        MappedTrace _trace;
+    };
+
+}
+
+#endif //FREESOULS_FSEAMTRACE_HPP
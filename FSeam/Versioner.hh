@@ -0,0 +1,3 @@
+#define FSEAM_VERSION_MAJOR 1
+#define FSEAM_VERSION_MINOR 0
+#define FSEAM_VERSION_PATCH 1
@@ -0,0 +1,264 @@
+#! /usr/bin/env python
+# MIT License
+#
+# Copyright (c) 2019 Quentin Balland
+# Project : https://github.com/FreeYourSoul/FSeam
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""
+libclang frontend of the FSeam generator : parse the header with the real compiler frontend (clang python bindings)
+and expose the same structure as CppHeaderParser.CppHeader (classes, functions, includes) to the FSeamerFile.
+
+The header is parsed alone (one translation unit per header) with the include folders of the tested target, the
+parsing of the bodies is skipped. A precompiled preamble (pch) can be provided in order to not re-parse the common
+includes (standard library) for each header. The preamble is rebuilt when the clang arguments change, when one of the
+files it includes changes, or when a header fails to parse with it.
+"""
+
+import json
+import os
+import re
+
+import CppHeaderParser
+
+try:
+    import clang.cindex as cindex
+except ImportError:
+    cindex = None
+
+INCLUDE_REGEX = r"^\s*#\s*include\s*([<\"][^>\"]+[>\"])"
+ACCESS_LEVELS = ["public", "protected", "private"]
+
+_index = None
+
+
+class ClangParseError(CppHeaderParser.CppParseError):
+    pass
+
+
+def _getIndex(libclangPath=None):
+    global _index
+    if cindex is None:
+        raise ClangParseError("FSeam clang frontend requires the clang python bindings (pip install libclang)")
+    if _index is None:
+        if libclangPath is not None:
+            cindex.Config.set_library_file(libclangPath)
+        _index = cindex.Index.create()
+    return _index
+
+
+def _qualifiedName(cursor):
+    _names = []
+    _parent = cursor.semantic_parent
+    while _parent is not None and _parent.kind != cindex.CursorKind.TRANSLATION_UNIT:
+        if _parent.spelling:
+            _names.insert(0, _parent.spelling)
+        _parent = _parent.semantic_parent
+    return "::".join(_names)
+
+
+def _typeSpelling(cppType):
+    """
+    Spelling of the type as written in the header, user types declared in a namespace are fully qualified (the data
+    structure of the FSeamMockData.hpp is not declared in the namespace of the header)
+    """
+    _spelling = cppType.spelling
+    _underlying = cppType
+    while _underlying.kind in [cindex.TypeKind.POINTER, cindex.TypeKind.LVALUEREFERENCE,
+                               cindex.TypeKind.RVALUEREFERENCE]:
+        _underlying = _underlying.get_pointee()
+    _declaration = _underlying.get_declaration()
+    if _declaration.kind in [cindex.CursorKind.STRUCT_DECL, cindex.CursorKind.CLASS_DECL,
+                             cindex.CursorKind.ENUM_DECL, cindex.CursorKind.TYPEDEF_DECL,
+                             cindex.CursorKind.TYPE_ALIAS_DECL]:
+        _scope = _qualifiedName(_declaration)
+        _name = _declaration.spelling
+        if _scope and not _scope.startswith("std") and _scope + "::" + _name not in _spelling:
+            _spelling = re.sub(r"(?<![\w:])" + re.escape(_name) + r"(?!\w)", _scope + "::" + _name, _spelling, 1)
+    return _spelling
+
+
+def _tokens(cursor):
+    return [t.spelling for t in cursor.get_tokens()]
+
+
+def _isDefined(cursor, headerContent):
+    """
+    Method defined in the header (inline, default or deleted), as the bodies are skipped by the parsing (not part of
+    the extent of the cursor) the source following the declaration is checked (offset of the extent are in bytes)
+    """
+    _tokens_ = _tokens(cursor)
+    if cursor.is_definition() or (len(_tokens_) > 1 and _tokens_[-2] == "="):
+        return True
+    _following = headerContent[cursor.extent.end.offset:].lstrip()
+    return _following.startswith(b"{") or (_following.startswith(b":") and not _following.startswith(b"::"))
+
+
+class ClangHeader:
+    """
+    Header parsed by libclang, the fields classes / functions / includes follow the format of CppHeaderParser
+    """
+
+    def __init__(self, headerPath, includeFolders=None, pchPath=None, extraArgs=None, libclangPath=None):
+        """
+        :param headerPath: header file to parse
+        :param includeFolders: include folders of the tested target
+        :param pchPath: precompiled preamble to use, created from the includes of the header if it doesn't exist yet
+                        or is stale (see _isPreambleValid)
+        :param extraArgs: additional arguments given to clang
+        :param libclangPath: path of the libclang library (if not found by the clang python bindings)
+        """
+        self.headerPath = os.path.abspath(headerPath)
+        self.classes = {}
+        self.functions = []
+        self.includes = []
+        # files included by the translation unit (see FSeamerFile.getDependencies)
+        self.dependencies = []
+        _index = _getIndex(libclangPath)
+        _args = ["-x", "c++", "-std=c++17"] + ["-I" + i for i in (includeFolders or []) if i] + (extraArgs or [])
+        _tu, _errors = None, []
+        if pchPath is not None:
+            if not self._isPreambleValid(_args, pchPath):
+                self._createPreamble(_index, _args, pchPath)
+            _tu, _errors = self._parse(_index, _args + ["-include-pch", pchPath])
+            if len(_errors) > 0:
+                # the preamble can still be stale (include folders content changed), rebuilt from this header
+                self._createPreamble(_index, _args, pchPath)
+                _tu, _errors = self._parse(_index, _args + ["-include-pch", pchPath])
+        else:
+            _tu, _errors = self._parse(_index, _args)
+        if len(_errors) > 0:
+            raise ClangParseError("FSeam clang frontend failed to parse " + self.headerPath + " :\n" + "\n".join(_errors))
+        with open(self.headerPath, "rb") as _header:
+            self.headerContent = _header.read()
+        self.dependencies = sorted(set(os.path.abspath(i.include.name) for i in _tu.get_includes()))
+        self._visit(_tu.cursor)
+
+    # =====Privates methods =====
+
+    def _parse(self, index, args):
+        """
+        :return: translation unit of the header and its errors
+        """
+        _options = cindex.TranslationUnit.PARSE_SKIP_FUNCTION_BODIES | \
+                   cindex.TranslationUnit.PARSE_INCOMPLETE | \
+                   cindex.TranslationUnit.PARSE_DETAILED_PROCESSING_RECORD
+        try:
+            _tu = index.parse(self.headerPath, args=args, options=_options)
+        except cindex.TranslationUnitLoadError as e:
+            raise ClangParseError("FSeam clang frontend failed to parse " + self.headerPath + " : " + str(e))
+        return _tu, [str(d) for d in _tu.diagnostics if d.severity >= cindex.Diagnostic.Error]
+
+    @staticmethod
+    def _preambleKeyPath(pchPath):
+        return pchPath + ".json"
+
+    @staticmethod
+    def _isPreambleValid(args, pchPath):
+        """
+        The preamble is valid if it has been built with the same clang arguments, and none of the files it includes has
+        been modified (or removed) since (recorded in the key file written next to the preamble)
+        """
+        try:
+            with open(ClangHeader._preambleKeyPath(pchPath), "r") as _keyFile:
+                _key = json.load(_keyFile)
+            _pchTime = os.path.getmtime(pchPath)
+            return _key["args"] == args and all(os.path.getmtime(d) <= _pchTime for d in _key["dependencies"])
+        except (OSError, ValueError, KeyError):
+            return False
+
+    def _createPreamble(self, index, args, pchPath):
+        """
+        The preamble is made of the includes of the header parsed when it is (re)built, it is used as a prefix of all the
+        headers parsed afterward (include guards skip the includes already in the preamble)
+        """
+        with open(self.headerPath, "r") as _header:
+            _includes = [m.group(0).strip() for m in (re.match(INCLUDE_REGEX, l) for l in _header) if m is not None]
+        # relative includes of the header are resolved from its folder
+        _preamble = os.path.join(os.path.dirname(self.headerPath), "fseam_preamble.hh")
+        _tu = index.parse(_preamble, args=args, unsaved_files=[(_preamble, "\n".join(_includes) + "\n")],
+                          options=cindex.TranslationUnit.PARSE_INCOMPLETE)
+        _errors = [str(d) for d in _tu.diagnostics if d.severity >= cindex.Diagnostic.Error]
+        if len(_errors) > 0:
+            raise ClangParseError("FSeam clang frontend failed to build the preamble " + pchPath + " from the includes of " +
+                                  self.headerPath + " :\n" + "\n".join(_errors))
+        _tu.save(pchPath)
+        with open(self._preambleKeyPath(pchPath), "w") as _keyFile:
+            json.dump({"args": args, "includes": _includes,
+                       "dependencies": sorted(set(os.path.abspath(i.include.name) for i in _tu.get_includes()))}, _keyFile)
+
+    def _isFromHeader(self, cursor):
+        return cursor.location.file is not None and os.path.abspath(cursor.location.file.name) == self.headerPath
+
+    def _visit(self, cursor):
+        for child in cursor.get_children():
+            if child.kind == cindex.CursorKind.INCLUSION_DIRECTIVE:
+                if self._isFromHeader(child):
+                    self.includes.append("".join(_tokens(child)[2:]))
+            elif not self._isFromHeader(child):
+                continue
+            elif child.kind == cindex.CursorKind.NAMESPACE:
+                self._visit(child)
+            elif child.kind in [cindex.CursorKind.CLASS_DECL, cindex.CursorKind.STRUCT_DECL] and child.is_definition():
+                self._registerClass(child)
+            elif child.kind == cindex.CursorKind.FUNCTION_DECL and not _isDefined(child, self.headerContent):
+                _namespace = _qualifiedName(child)
+                self.functions.append({
+                    "name": child.spelling,
+                    "rtnType": _typeSpelling(child.result_type),
+                    "namespace": _namespace + "::" if _namespace else "",
+                    "parameters": self._parameters(child)
+                })
+
+    def _registerClass(self, cursor):
+        _path = _qualifiedName(cursor)
+        _methods = {level: [] for level in ACCESS_LEVELS}
+        for child in cursor.get_children():
+            if child.kind in [cindex.CursorKind.CLASS_DECL, cindex.CursorKind.STRUCT_DECL] and child.is_definition():
+                self._registerClass(child)
+                continue
+            if child.kind not in [cindex.CursorKind.CXX_METHOD, cindex.CursorKind.CONSTRUCTOR,
+                                  cindex.CursorKind.DESTRUCTOR] or child.spelling.startswith("operator"):
+                continue
+            _level = child.access_specifier.name.lower()
+            if _level not in _methods:
+                continue
+            _isConstructor = child.kind == cindex.CursorKind.CONSTRUCTOR
+            _isDestructor = child.kind == cindex.CursorKind.DESTRUCTOR
+            _methods[_level].append({
+                "name": child.spelling.replace("~", ""),
+                "path": _path + "::" + cursor.spelling if _path else cursor.spelling,
+                "rtnType": "void" if _isConstructor or _isDestructor else _typeSpelling(child.result_type),
+                "namespace": _path + "::" if _path else "",
+                "parameters": self._parameters(child),
+                "pure_virtual": child.is_pure_virtual_method(),
+                "defined": _isDefined(child, self.headerContent),
+                "static": child.is_static_method(),
+                "const": child.is_const_method(),
+                "noexcept": "noexcept" if "noexcept" in _tokens(child) else None,
+                "constructor": _isConstructor,
+                "destructor": _isDestructor
+            })
+        # nested classes are registered under their own name, their namespace contains the enclosing class
+        self.classes[cursor.spelling] = {"namespace": _path, "methods": _methods}
+
+    @staticmethod
+    def _parameters(cursor):
+        return [{"type": _typeSpelling(a.type), "name": a.spelling} for a in cursor.get_arguments()]
@@ -0,0 +1,328 @@
+#! /usr/bin/env python
+# MIT License
+#
+# Copyright (c) 2019 Quentin Balland
+# Project : https://github.com/FreeYourSoul/FSeam
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""
+Watch mode of the FSeam generator : a persistent process (FSeamerFile.py --watch --daemon=<socket>) keeping the parsed
+headers in memory.
+
+The generator called with --daemon=<socket> (by the build) sends its command line to the daemon instead of generating
+the mock itself. The daemon replies immediately if the mock is up to date, generates it with the cached parsing of the
+header otherwise. If no daemon is listening, the generator falls back to the generation in its own process.
+
+The headers (and the usage files) of the mocks generated through the daemon are watched with inotify, the mocks are
+re-generated as soon as one of those files is saved: when the build runs, the generated files are already up to date.
+"""
+
+import copy
+import ctypes
+import ctypes.util
+import io
+import json
+import os
+import re
+import select
+import socket
+import struct
+import sys
+import time
+
+import FSeamerFile
+
+DEFAULT_SOCKET = "/tmp/fseam-" + str(os.getuid()) + ".sock"
+# options changing the parsing of the header (the parsed headers are cached per options)
+PARSING_OPTIONS_REGEX = r"^(--frontend=|-I|--pch=|--libclang=|--clang-arg=)"
+# events grouped before re-generation (editors write a file in several steps)
+DEBOUNCE_SECONDS = 0.02
+
+IN_CLOSE_WRITE = 0x00000008
+IN_MOVED_TO = 0x00000080
+IN_CREATE = 0x00000100
+INOTIFY_EVENT_HEADER = struct.Struct("iIII")
+
+
+def _stamp(path):
+    try:
+        _stat = os.stat(path)
+        return [_stat.st_mtime_ns, _stat.st_size]
+    except OSError:
+        return None
+
+
+class ParsedHeaders:
+    """
+    Parsed headers, kept as long as the header file doesn't change
+    """
+
+    def __init__(self):
+        self._headers = {}
+
+    def frontend(self, baseFrontend, options):
+        """
+        :param baseFrontend: frontend used to parse the header if not cached (CppHeaderParser if None)
+        :param options: generator options, the options changing the parsing are part of the cache key
+        :return: frontend returning a copy of the cached parsing (the FSeamerFile modifies it)
+        """
+        _parsingOptions = tuple(o for o in options if re.match(PARSING_OPTIONS_REGEX, o))
+
+        def _parse(headerPath):
+            _key = (os.path.abspath(headerPath), _parsingOptions)
+            # the parsing of the clang frontend also depends on the files included by the header
+            if _key not in self._headers or any(_stamp(p) != s for p, s in self._headers[_key][0].items()):
+                _stampHeader = _stamp(headerPath)
+                _parsed = (baseFrontend or FSeamerFile.CppHeaderParser.CppHeader)(headerPath)
+                _stamps = {p: _stamp(p) for p in getattr(_parsed, "dependencies", [])}
+                _stamps[_key[0]] = _stampHeader
+                self._headers[_key] = (_stamps, _parsed)
+            return copy.deepcopy(self._headers[_key][1])
+        return _parse
+
+
+class Inotify:
+    """
+    Minimal inotify binding (ctypes), the folders containing the watched files are watched (editors often replace the
+    file instead of writing it)
+    """
+
+    def __init__(self):
+        _libc = ctypes.CDLL(ctypes.util.find_library("c"), use_errno=True)
+        self._addWatch = _libc.inotify_add_watch
+        self._addWatch.argtypes = [ctypes.c_int, ctypes.c_char_p, ctypes.c_uint32]
+        self.fd = _libc.inotify_init1(os.O_NONBLOCK | os.O_CLOEXEC)
+        if self.fd < 0:
+            raise OSError(ctypes.get_errno(), "inotify_init1 failed")
+        self._folders = {}
+
+    def watch(self, folder):
+        if folder in self._folders.values():
+            return
+        _wd = self._addWatch(self.fd, folder.encode(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE)
+        if _wd >= 0:
+            self._folders[_wd] = folder
+
+    def read(self):
+        """
+        :return: paths of the files written since the last read
+        """
+        _paths = set()
+        try:
+            _buffer = os.read(self.fd, 64 * 1024)
+        except BlockingIOError:
+            return _paths
+        _offset = 0
+        while _offset < len(_buffer):
+            _wd, _mask, _cookie, _length = INOTIFY_EVENT_HEADER.unpack_from(_buffer, _offset)
+            _offset += INOTIFY_EVENT_HEADER.size
+            _name = _buffer[_offset:_offset + _length].rstrip(b"\0").decode()
+            _offset += _length
+            if _wd in self._folders and _name:
+                _paths.add(os.path.join(self._folders[_wd], _name))
+        return _paths
+
+    def close(self):
+        os.close(self.fd)
+
+
+class WatchDaemon:
+    """
+    Serve the generation requests of the build (FSeamerFile.py --daemon=<socket>) and re-generate the mocks when their
+    header is saved
+    """
+
+    def __init__(self, socketPath, log=sys.stdout):
+        self.socketPath = socketPath
+        self.log = log
+        self.parsedHeaders = ParsedHeaders()
+        # generations done through the daemon, key : (header to mock, destination), value : command line and stamps
+        self.generations = {}
+        self.running = True
+        try:
+            self.inotify = Inotify()
+        except (OSError, AttributeError, TypeError):
+            self.inotify = None
+            self._print("FSeam watch : inotify unavailable, the mocks are only generated on request")
+        if os.path.exists(socketPath):
+            os.unlink(socketPath)
+        self.server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.server.bind(socketPath)
+        self.server.listen(16)
+
+    def serveForever(self):
+        self._print("FSeam watch : listening on " + self.socketPath)
+        _inputs = [self.server] + ([self.inotify.fd] if self.inotify else [])
+        try:
+            while self.running:
+                _ready, _, _ = select.select(_inputs, [], [], 0.1)
+                if self.inotify and self.inotify.fd in _ready:
+                    time.sleep(DEBOUNCE_SECONDS)
+                    self._regenerateChanged(self.inotify.read())
+                if self.server in _ready:
+                    self._accept()
+        finally:
+            self.server.close()
+            if os.path.exists(self.socketPath):
+                os.unlink(self.socketPath)
+            if self.inotify:
+                self.inotify.close()
+
+    def stop(self):
+        self.running = False
+
+    # =====Privates methods =====
+
+    def _print(self, message):
+        if self.log is not None:
+            print(message, file=self.log, flush=True)
+
+    def _accept(self):
+        """
+        Serve a connection, a failing request (malformed, client gone while answering...) doesn't stop the daemon
+        """
+        try:
+            _connection, _ = self.server.accept()
+        except OSError as e:
+            self._print("FSeam watch : accept failed, " + str(e))
+            return
+        with _connection:
+            try:
+                self._serve(_connection)
+            except Exception as e:
+                self._print("FSeam watch : request failed, " + type(e).__name__ + " : " + str(e))
+
+    def _serve(self, connection):
+        with connection.makefile("rw") as _stream:
+            try:
+                _request = json.loads(_stream.readline())
+                _status, _output = self._request(_request["argv"], _request["cwd"])
+            except (ValueError, KeyError, TypeError, IndexError, OSError) as e:
+                _status, _output = 1, "FSeam watch : invalid request, " + type(e).__name__ + " : " + str(e) + "\n"
+                self._print(_output.rstrip())
+            _stream.write(json.dumps({"status": _status, "output": _output}) + "\n")
+
+    def _request(self, argv, cwd):
+        os.chdir(cwd)
+        _key = self._key(argv)
+        _generation = self.generations.get(_key)
+        if _generation is not None and _generation["argv"] == argv and _generation["stamps"] == self._stamps(argv) \
+                and os.path.exists(_generation["output"]):
+            # the build considers the mock out of date (one of its dependencies is newer), touched to be up to date
+            os.utime(_generation["output"])
+            return 0, "FSeam file is already generated at path " + _generation["output"] + "\n"
+        return self._generate(argv, cwd)
+
+    def _generate(self, argv, cwd):
+        _begin = time.perf_counter()
+        _output = io.StringIO()
+        _status = 0
+        # reported on its own stream, the process-wide sys.stdout is left untouched (the daemon may be embedded)
+        try:
+            FSeamerFile.generateFromCommandLine(argv, self.parsedHeaders, _output)
+        except SystemExit as e:
+            _status = e.code if isinstance(e.code, int) else 1
+        except Exception as e:
+            _output.write(type(e).__name__ + " : " + str(e) + "\n")
+            _status = 1
+        _key = self._key(argv)
+        if _status == 0:
+            self.generations[_key] = {"argv": argv, "cwd": cwd, "stamps": self._stamps(argv),
+                                      "output": self._outputPath(argv)}
+            if self.inotify:
+                for path in self.generations[_key]["stamps"]:
+                    self.inotify.watch(os.path.dirname(path))
+        else:
+            self.generations.pop(_key, None)
+        self._print("FSeam watch : " + _key[0] + " generated in %.1fms" % ((time.perf_counter() - _begin) * 1000)
+                    + ("" if _status == 0 else " (failed)\n" + _output.getvalue()))
+        return _status, _output.getvalue()
+
+    def _regenerateChanged(self, paths):
+        for generation in list(self.generations.values()):
+            try:
+                if any(p in generation["stamps"] and _stamp(p) != generation["stamps"][p] for p in paths):
+                    os.chdir(generation["cwd"])
+                    self._generate(generation["argv"], generation["cwd"])
+            except Exception as e:
+                # the other mocks are still re-generated, the build requests the failed one again
+                self._print("FSeam watch : re-generation of " + self._key(generation["argv"])[0] + " failed, " +
+                            type(e).__name__ + " : " + str(e))
+
+    @staticmethod
+    def _key(argv):
+        _args = [a for a in argv if not a.startswith("-")]
+        return _args[0], os.path.abspath(_args[1])
+
+    @staticmethod
+    def _outputPath(argv):
+        _args = [a for a in argv if not a.startswith("-")]
+        _header = re.sub(FSeamerFile.METHOD_SELECTOR_REGEX, r"\1", _args[0])
+        _fileName = os.path.basename(_header)
+        return os.path.join(os.path.abspath(_args[1]), os.path.splitext(_fileName)[0] + ".fseam.cc")
+
+    @staticmethod
+    def _stamps(argv):
+        """
+        :return: stamps of the files the generation depends on (header, usage files and usage lists, and the included
+                 headers listed in the dependency file if any)
+        """
+        _args = [a for a in argv if not a.startswith("-")]
+        _paths = [re.sub(FSeamerFile.METHOD_SELECTOR_REGEX, r"\1", _args[0])]
+        _paths += [o.split("=", 1)[1] for o in argv if o.startswith("--usage=")]
+        for usageList in [o.split("=", 1)[1] for o in argv if o.startswith("--usage-list=")]:
+            _paths.append(usageList)
+            if os.path.exists(usageList):
+                with open(usageList, "r") as _usageListFile:
+                    _paths += [l.strip() for l in _usageListFile if l.strip()]
+        for depFile in [o.split("=", 1)[1] for o in argv if o.startswith("--depfile=")]:
+            if os.path.exists(depFile):
+                with open(depFile, "r") as _depFile:
+                    # target: dependency \
+                    #   dependency...
+                    _content = _depFile.read().replace("\\\n", " ").split(":", 1)[-1]
+                _paths += [p.replace("\\ ", " ").replace("\\#", "#").replace("$$", "$")
+                           for p in re.split(r"(?<!\\)\s+", _content.strip()) if p]
+        return {os.path.abspath(p): _stamp(p) for p in _paths}
+
+
+def request(socketPath, argv):
+    """
+    Send a generation request to the daemon listening on socketPath
+
+    :param socketPath: socket of the daemon
+    :param argv: command line of the generator
+    :return: status of the generation, None if no daemon is listening
+    """
+    _connection = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        _connection.connect(socketPath)
+    except OSError:
+        _connection.close()
+        return None
+    with _connection, _connection.makefile("rw") as _stream:
+        _stream.write(json.dumps({"argv": argv, "cwd": os.getcwd()}) + "\n")
+        _stream.flush()
+        _reply = _stream.readline()
+    if not _reply:
+        return None
+    _reply = json.loads(_reply)
+    sys.stdout.write(_reply["output"])
+    return _reply["status"]
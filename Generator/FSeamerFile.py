@@ -48,31 +48,62 @@ FREE_FUNC_FAKE_CLASS = "FreeFunction"
 RETURN_SUFFIX = "_ReturnValue"
 CLASS_START_FMT = "//Beginning of {}"
 CLASS_END_FMT = "// End of DataStructure {}\n\n\n"
+DATA_BLOCK_START_REGEX = r"//Beginning of (\w+)\n"
+SPEC_BLOCK_START_REGEX = r"\n\n// Duping/Expectations specializations for (\w+)\n"
+SPEC_BLOCK_END_FMT = "// End of Specialization for {}\n\n"
+FREE_FUNC_SPEC_BLOCK_START_REGEX = r"// Generated duping for method " + FREE_FUNC_FAKE_CLASS + r"::(\w+) begin\n"
+FREE_FUNC_SPEC_BLOCK_END_FMT = "// Generated duping for method " + FREE_FUNC_FAKE_CLASS + "::{} end\n"
+METHOD_SELECTOR_REGEX = r"^(.*\.(?:hh|hpp|h)):(.+)$"
+CALLED_COMPARATORS = ["FSeam::IsNot", "FSeam::AtMost", "FSeam::AtLeast", "FSeam::NeverCalled", "FSeam::VerifyCompare"]
+USAGE_METHOD_REGEX = r"(\w+)(?=::(~?\w+))"
+USAGE_COMPARATOR_REGEX = r"\b(IsNot|AtMost|AtLeast|NeverCalled|VerifyCompare|expectArgTable)\b"
+INCLUDE_REGEX = r"^\s*#\s*include\s*([<\"])([^>\"]+)[>\"]"
+# move-only asynchronous return types having FSeam::AsyncReturn traits, completed by dupeAsyncReturn (the other
+# awaitable templates are registered with the --async-return option of the generator)
+ASYNC_RETURN_TYPES = ["std::future", "std::shared_future"]
+ASYNC_RETURN_REGEX_FMT = r"(?:^|\s)(?:::)?(?:{})\s*<"
 
 
 class FSeamerFile:
 
     # =====Public methods =====
 
-    def __init__(self, pathFile):
+    def __init__(self, pathFile, methodSelectors=None, frontend=None, usage=None, asyncReturnTypes=None, output=None):
         """
         :param pathFile: cpp header file that will be parsed at the "seamParse" call
+        :param methodSelectors: list of method to mock (Class::method, or function name for free functions), if None
+                                all methods of the header are mocked
+        :param frontend: callable parsing the header file into classes / functions / includes (CppHeaderParser format),
+                         by default CppHeaderParser is used
+        :param usage: methods (Class::method) and comparators referenced by the tests (see scanUsage), if provided the
+                      dupeReturn / expectArg specializations are generated only for those (the others use the generic
+                      implementation of FSeam.hpp), if None specializations are generated for all the methods
+        :param asyncReturnTypes: awaitable templates (namespace::Task) specialized in FSeam::AsyncReturn by the tests, in
+                                 addition to std::future and std::shared_future, no dupeReturn specialization is generated
+                                 for the methods returning them
+        :param output: stream on which the parsing errors are written, sys.stdout by default
         """
+        self.usage = usage
+        self.asyncReturnRegex = ASYNC_RETURN_REGEX_FMT.format(
+            "|".join([re.escape(t.lstrip(":")) for t in ASYNC_RETURN_TYPES + (asyncReturnTypes or [])]))
+        self.methodSelectors = set(methodSelectors) if methodSelectors else None
         self.mapClassMethods = {}
         self.codeSeam = HEADER_INFO
         self.headerPath = os.path.normpath(pathFile)
         self.fileName = ntpath.basename(self.headerPath)
-        self.specContent = ""
+        self.specContent = []
         self.functionSignatureMapping = {}
         self.fullClassNameMap = {}
         self.staticFunction = list()
         self.freeFunctionClassMethodId = None
+        self.freeFunctionClassMethodIdNames = set()
         self.freeFunctionDataStructContent = None
+        self.freeFunctionDataStructMethods = set()
         self.freeFunctionTemplateSpecContent = ""
         try:
-            self.cppHeader = CppHeaderParser.CppHeader(self.headerPath)
+            self.cppHeader = (frontend or CppHeaderParser.CppHeader)(self.headerPath)
         except CppHeaderParser.CppParseError as e:
-            print(e)
+            print(e, file=output)
             sys.exit(1)
 
     def seamParse(self):
@@ -81,8 +112,8 @@ class FSeamerFile:
         header file
         :return: FSeam cpp content to be filed into a file
         """
-        self.codeSeam = self.codeSeam.replace(FILENAME, self.fileName)
-        self.codeSeam += self._extractHeaders()
+        # code is emitted per class into a list joined once (generation time linear with the size of the header)
+        _codeSeam = [self.codeSeam.replace(FILENAME, self.fileName), self._extractHeaders()]
         _classes = self.cppHeader.classes
         for c in _classes:
             _className = c
@@ -90,36 +121,66 @@ class FSeamerFile:
             if len(_classes[c]["namespace"]) > 0:
                 self.fullClassNameMap[c] = _classes[c]["namespace"] + "::" + _className
             for encapsulationLevel in _classes[c]["methods"]:
-                self.codeSeam += "\n// " + _className + " " + encapsulationLevel
-                self.codeSeam += self._extractMethodsFromClass(_className, _classes[c]["methods"][encapsulationLevel])
-            self.codeSeam = self.codeSeam.replace(CLASSNAME, _className)
+                _codeSeam.append("\n// " + _className + " " + encapsulationLevel)
+                _codeSeam.append(self._extractMethodsFromClass(_className, _classes[c]["methods"][encapsulationLevel])
+                                 .replace(CLASSNAME, _className))
         self.cppHeader.functions.extend(self.staticFunction)
         if len(self.cppHeader.functions) > 0:
             _listFunc = list()
             if FREE_FUNC_FAKE_CLASS in self.mapClassMethods:
                 _listFunc = self.mapClassMethods[FREE_FUNC_FAKE_CLASS]
-            self.codeSeam += "\n// Free functions (put into fake class " + FREE_FUNC_FAKE_CLASS + ")\n"
+            _codeSeam.append("\n// Free functions (put into fake class " + FREE_FUNC_FAKE_CLASS + ")\n")
             for functionData in self.cppHeader.functions:
                 _listFunc.append(functionData["name"])
-                self.codeSeam += self._extractFreeFunctions(functionData)
+                _codeSeam.append(self._extractFreeFunctions(functionData))
             self.mapClassMethods[FREE_FUNC_FAKE_CLASS] = _listFunc
             self.fullClassNameMap[FREE_FUNC_FAKE_CLASS] = FREE_FUNC_FAKE_CLASS
+        self.codeSeam = "".join(_codeSeam)
         return self.codeSeam
 
-    def isSeamFileUpToDate(self, fileFSeamPath):
+    def isSeamFileUpToDate(self, fileFSeamPath, dependencies=None):
         """
         Check if the newly created file (the FSeam mock file) has been updated sooner than the header it is originated
         from
         :param fileFSeamPath: path of the FSeam file
+        :param dependencies: files the generation depends on (see getDependencies), the header only if None
         :return: True if the file given as parameter is more up to date than the initial header file used for its
                  generation
         """
         if not os.path.exists(fileFSeamPath):
             return False
         fileMockedTime = os.stat(fileFSeamPath).st_mtime
-        fileToMockTime = os.stat(self.headerPath).st_mtime
+        fileToMockTime = max(os.stat(d).st_mtime for d in (dependencies or [self.headerPath]) if os.path.exists(d))
         return fileMockedTime > fileToMockTime
 
+    def getDependencies(self, includeFolders=None):
+        """
+        Headers the mock depends on: a change in one of the headers included by the mocked header (a type used in a
+        mocked signature for example) requires the mock to be re-generated
+        :param includeFolders: include folders in which the includes are resolved (the folder of the including file is
+                               searched first for the "quoted" includes)
+        :return: absolute paths of the header and of the headers it includes (recursively), the includes not found in
+                 the include folders (system headers) are ignored
+        """
+        _folders = [os.path.abspath(f) for f in (includeFolders or []) if f]
+        # the clang frontend reports the files included by the translation unit (except the ones of the preamble)
+        _dependencies = [os.path.abspath(self.headerPath)] + list(getattr(self.cppHeader, "dependencies", []))
+        _known = set(_dependencies)
+        _toScan = [_dependencies[0]]
+        while _toScan:
+            _file = _toScan.pop()
+            with open(_file, "r", errors="replace") as _content:
+                _includes = [m.groups() for m in (re.match(INCLUDE_REGEX, l) for l in _content) if m is not None]
+            for delimiter, include in _includes:
+                _candidates = ([os.path.dirname(_file)] if delimiter == "\"" else []) + _folders
+                _found = next((os.path.abspath(os.path.join(c, include)) for c in _candidates
+                               if os.path.isfile(os.path.join(c, include))), None)
+                if _found is not None and _found not in _known:
+                    _known.add(_found)
+                    _dependencies.append(_found)
+                    _toScan.append(_found)
+        return _dependencies
+
     def getFSeamGeneratedFileName(self):
         """
         :return: name of the file to generate: <headerFileNameWithoutExtension>.fseam.cc
@@ -152,31 +213,37 @@ class FSeamerFile:
             content += "#include <FSeam/FSeam.hpp>\n\n"
         if BASE_HEADER_CODE + "<" + self.fileName + ">\n" not in content:
             content += BASE_HEADER_CODE + "<" + self.fileName + ">\n"
-        content += "namespace FSeam {\n"
+        if FREE_FUNC_FAKE_CLASS in self.mapClassMethods:
+            self.freeFunctionDataStructContent = self._getCurrentFreeFunctionDataContent(content)
+            self.freeFunctionDataStructMethods = set(re.findall(r" \* method metadata : " + FREE_FUNC_FAKE_CLASS + r"::(\w+)\n",
+                                                                self.freeFunctionDataStructContent))
+            # identifiers of the free functions of other headers are kept, the ones of this header are re-generated
+            _regenerated = self.functionSignatureMapping.get(FREE_FUNC_FAKE_CLASS, {}).keys()
+            self.freeFunctionClassMethodId = "".join(
+                [l for l in self._getCurrentFreeFunctionClassMethodIdContent(content).splitlines(True)
+                 if re.match(r"\s*struct (\w+) \{", l) is None or re.match(r"\s*struct (\w+) \{", l).group(1) not in _regenerated])
+            self.freeFunctionClassMethodIdNames = set(re.findall(r"struct (\w+) \{", self.freeFunctionClassMethodId))
+        # data of the re-generated classes are cleared in one pass, the new ones are appended at the end of the file
+        _content = [self._clearDataStructureData(content, self.mapClassMethods.keys()), "namespace FSeam {\n"]
         for className, methods in self.mapClassMethods.items():
-            content += CLASS_START_FMT.format(className)
-            if FREE_FUNC_FAKE_CLASS is className:
-                self.freeFunctionDataStructContent = self._getCurrentFreeFunctionDataContent(content)
-                self.freeFunctionClassMethodId = self._getCurrentFreeFunctionClassMethodIdContent(content)
-            if methods or className in content:
-                content = self._clearDataStructureData(content, className)
-            _struct = "\nstruct " + className + "Data {\n"
+            _content.append(CLASS_START_FMT.format(className))
+            _content.append("\nstruct " + className + "Data {\n")
             if FREE_FUNC_FAKE_CLASS is className and self.freeFunctionDataStructContent is not None:
-                _struct += self.freeFunctionDataStructContent
+                _content.append(self.freeFunctionDataStructContent)
             for methodName in methods:
                 if FREE_FUNC_FAKE_CLASS is className:
-                    _struct += self._extractDataStructMethod(className, methodName, self.freeFunctionDataStructContent)
+                    _content.append(self._extractDataStructMethod(className, methodName, self.freeFunctionDataStructMethods))
                 else:
-                    _struct += self._extractDataStructMethod(className, methodName)
-            content += _struct + "};\n\n"
+                    _content.append(self._extractDataStructMethod(className, methodName))
+            _content.append("};\n\n")
             if className is not FREE_FUNC_FAKE_CLASS:
-                content += "// NameTypeTraits\ntemplate <> struct TypeParseTraits<" + self.fullClassNameMap[className] + \
-                           "> {\n" + INDENT + "inline static const std::string ClassName = \"" + className + "\";\n};\n"
+                _content.append("// NameTypeTraits\ntemplate <> struct TypeParseTraits<" + self.fullClassNameMap[className] +
+                                "> {\n" + INDENT + "static constexpr std::string_view ClassName = \"" + className + "\";\n};\n")
             if className in self.functionSignatureMapping:
-                content += self._generateDupeVerifyTemplateSpecialization(className)
-            content += CLASS_END_FMT.format(className)
-        content += "}\n"
-        content = re.sub("namespace FSeam {[\n ]+}\n", "", content)
+                _content.append(self._generateDupeVerifyTemplateSpecialization(className))
+            _content.append(CLASS_END_FMT.format(className))
+        _content.append("}\n")
+        content = re.sub("namespace FSeam {[\n ]+}\n", "", "".join(_content))
         # content = re.sub("struct [a-zA-Z0-9_]+ {[\n ]+};\n", "", content)
         return content + LOCKING_FOOTER
 
@@ -189,14 +256,9 @@ class FSeamerFile:
         if not content or len(content) < 10:
             content = HEADER_INFO.replace(FILENAME, "FSeamSpecialization.hpp")
             content += "#include <FSeamMockData.hpp>\n\n"
-        for className, methods in self.mapClassMethods.items():
-            if FREE_FUNC_FAKE_CLASS is className:
-                for method in methods:
-                    if method in self.freeFunctionTemplateSpecContent:
-                        content = self._clearSpecializationFreeFunction(content, method)
-            else:
-                content = self._clearSpecialization(content, className)
-        return content + self.specContent + self.freeFunctionTemplateSpecContent
+        _freeFunctions = self.mapClassMethods.get(FREE_FUNC_FAKE_CLASS, [])
+        content = self._clearSpecialization(content, self.mapClassMethods.keys(), _freeFunctions)
+        return content + "".join(self.specContent) + self.freeFunctionTemplateSpecContent
 
     # =====Privates methods =====
 
@@ -209,12 +271,12 @@ class FSeamerFile:
         _fseamerCodeHeaders += BASE_HEADER_CODE + "<" + self.fileName + ">\n"
         return _fseamerCodeHeaders
 
-    def _extractDataStructMethod(self, className, methodName, excluderStruct=None):
+    def _extractDataStructMethod(self, className, methodName, excludedMethods=None):
         _methodData = ""
         if methodName in self.functionSignatureMapping[className].keys():
             if self.functionSignatureMapping[className][methodName]["isConstructorOrDestructor"] is True:
                 pass
-            elif excluderStruct is None or methodName not in excluderStruct:
+            elif excludedMethods is None or methodName not in excludedMethods:
                 _methodData = INDENT + "/**\n" + INDENT + " * method metadata : " + className + "::" + methodName + "\n" + INDENT + "**/\n"
                 for param in self.functionSignatureMapping[className][methodName]["params"]:
                     _paramType = param["type"].replace("& &", "&&")
@@ -223,6 +285,8 @@ class FSeamerFile:
                         typeStr = _paramType
                         if "&" in typeStr:
                             typeStr = "std::reference_wrapper<" + typeStr.replace("&", "") + "> "
+                        else:
+                            typeStr = "FSeam::Capture<" + typeStr + "> "
                         _methodData += INDENT + "std::optional<" + typeStr + "> " + methodName + "_" + _paramName + PARAM_SUFFIX + ";\n"
                 _returnType = self.functionSignatureMapping[className][methodName]["rtnType"].replace("&", "").replace("static ", "")
                 if _returnType != "void":
@@ -248,6 +312,9 @@ class FSeamerFile:
         _parametersName = [t["name"] for t in freeFunctionData["parameters"]]
         self._registerMethodIntoMethodSignatureMap(FREE_FUNC_FAKE_CLASS, _functionName, _returnType,
                                                    freeFunctionData["parameters"])
+        if not self._isSelected(_functionName, FREE_FUNC_FAKE_CLASS + "::" + _functionName,
+                                freeFunctionData["namespace"].split("::")[-2:][0] + "::" + _functionName):
+            return ""
         for i in range(len(_parametersType)):
             _signature += _parametersType[i] + " " + _parametersName[i]
             _signature = _signature.replace(" & & ", " && ")
@@ -258,8 +325,17 @@ class FSeamerFile:
         _functionFakeClassMethod += self._generateMethodContent(_returnType, FREE_FUNC_FAKE_CLASS, _functionName, True)
         return _functionFakeClassMethod + "\n}\n"
 
+    def _isSelected(self, *selectors):
+        """
+        Method selection (partial mocking of a header), the data structure / identifiers are generated for all methods
+        of the header, but only the selected methods are mocked (the other are linked from the real implementation)
+        :param selectors: names under which the method can be selected
+        :return: True if the method has to be mocked
+        """
+        return self.methodSelectors is None or any(s in self.methodSelectors for s in selectors)
+
     def _extractMethodsFromClass(self, className, methodsData):
-        _methods = "\n// Methods Mocked Implementation for class " + className + "\n"
+        _methods = ["\n// Methods Mocked Implementation for class " + className + "\n"]
         _lstMethodName = list()
 
         if className in self.mapClassMethods:
@@ -296,58 +372,118 @@ class FSeamerFile:
                     _signature += " const"
                 if methodData["noexcept"] is not None:
                     _signature += " noexcept"
+                if not self._isSelected(className + "::" + _methodsName):
+                    continue
                 methodContent = self._generateMethodContent(_returnType, className, _methodsName)
-                _methods += "\n" + _signature + " {\n" + methodContent + "\n}\n"
+                _methods.append("\n" + _signature + " {\n" + methodContent + "\n}\n")
 
         self.mapClassMethods[className] = _lstMethodName
-        return _methods
+        return "".join(_methods)
 
     def _generateDupeVerifyTemplateSpecialization(self, className): 
         ### TODO: extract _genSpecial for the MethodIdentifier in another method
-        _genSpecial = "// ClassMethodIdentifiers\n"
-        _genSpecial += "namespace " + className + " {\n"
+        _genSpecial = ["// ClassMethodIdentifiers\n", "namespace " + className + " {\n"]
         if self.freeFunctionClassMethodId is not None:
-            _genSpecial += self.freeFunctionClassMethodId
+            _genSpecial.append(self.freeFunctionClassMethodId)
         for methodName, methodsMapping in self.functionSignatureMapping[className].items():
-            if self.freeFunctionClassMethodId is None or methodName not in self.freeFunctionClassMethodId:
-                mn = methodName
-                if methodName.startswith("~"):
-                    mn = methodName.replace("~", "Destructor_")
-                _genSpecial += INDENT + "struct " + mn + " { inline static const std::string NAME = \"" + methodName + "\";};\n"
-        _genSpecial += "}\n"
-
-        _specContent = ""
+            mn = methodName
+            if methodName.startswith("~"):
+                mn = methodName.replace("~", "Destructor_")
+            if self.freeFunctionClassMethodId is None or mn not in self.freeFunctionClassMethodIdNames:
+                _genSpecial.append(INDENT + "struct " + mn + " { static constexpr std::string_view NAME = \"" + methodName + "\";" +
+                                   " static constexpr std::string_view CLASS_NAME = \"" + className + "\";" +
+                                   self._generateMethodIdentifierAccessors(className, methodName) +
+                                   self._generateMethodIdentifierSpecializations(className, methodName) + "};\n")
+        _genSpecial.append("}\n")
+
+        _specContent = []
         if FREE_FUNC_FAKE_CLASS is not className:
-            _specContent = "\n\n// Duping/Expectations specializations for " + className + "\n"
+            _specContent.append("\n\n// Duping/Expectations specializations for " + className + "\n")
         for methodName, methodMapping in self.functionSignatureMapping[className].items():
             if methodName.startswith("Destructor_"):
                 methodName.replace("Destructor_", "~")
             if (FREE_FUNC_FAKE_CLASS is className):
-                _specContent += "// Generated duping for method " + className + "::" + methodName + " begin\n"
+                _specContent.append("// Generated duping for method " + className + "::" + methodName + " begin\n")
             # Specialization for dupeReturn
-            if methodMapping["rtnType"].replace("static ", "") != "void":
+            if self._hasDupeReturnSpecialization(className, methodName):
                 _rtnType = "std::decay_t<" + methodMapping["rtnType"].replace("static ", "") + ">"
-                _specContent += "template <> void FSeam::MockClassVerifier::dupeReturn<FSeam::" + className + "::" + methodName + ", " + _rtnType + "> (" + _rtnType + " returnValue) {\n"
-                _specContent += INDENT + "this->dupeMethod(\"" + methodName + "\", [=](void *methodCallData) { \n"
-                _specContent += INDENT2 + "static_cast<FSeam::" + className + "Data *>(methodCallData)->" + methodName + RETURN_SUFFIX + " = returnValue;\n"
-                _specContent += INDENT + "}, true);\n}\n"
+                _specContent.append("template <> void FSeam::MockClassVerifier::dupeReturnSpecialized<FSeam::" + className + "::" + methodName + ", " + _rtnType + "> (" + _rtnType + " returnValue) {\n")
+                _specContent.append(INDENT + "this->dupeMethod(\"" + methodName + "\", [=](void *methodCallData) { \n")
+                _specContent.append(INDENT2 + "static_cast<FSeam::" + className + "Data *>(methodCallData)->" + methodName + RETURN_SUFFIX + " = returnValue;\n")
+                _specContent.append(INDENT + "}, true);\n}\n")
 
             # Specialization for verifyArg
-            if len(methodMapping["params"]) > 0:
-                _specContent += "// Expectation specializations for " + className + "::" + methodName + "\n"
-                for comparator in [None, "FSeam::IsNot", "FSeam::AtMost", "FSeam::AtLeast", "FSeam::NeverCalled", "FSeam::VerifyCompare"]:
-                    _specContent += self._generateSpecializationVerifyArg(className, methodName, methodMapping, comparator)
+            _comparators = self._getExpectArgSpecializations(className, methodName)
+            if len(_comparators) > 0:
+                _specContent.append("// Expectation specializations for " + className + "::" + methodName + "\n")
+                for comparator in _comparators:
+                    _specContent.append(self._generateSpecializationVerifyArg(className, methodName, methodMapping, comparator))
             if (FREE_FUNC_FAKE_CLASS is className):
-                _specContent += "// Generated duping for method " + className + "::" + methodName + " end\n"
+                _specContent.append("// Generated duping for method " + className + "::" + methodName + " end\n")
         # cleanup loops last separator tokens
-        _specContent = _specContent.replace(", >", ">").replace(", )", ")").replace(", \n);", ");").replace("(\n)", "()")
+        _specContent = "".join(_specContent).replace(", >", ">").replace(", )", ")").replace(", \n);", ");").replace("(\n)", "()")
         if FREE_FUNC_FAKE_CLASS is not className:
             _specContent += "// End of Specialization for " + className + "\n\n"
         if FREE_FUNC_FAKE_CLASS is className:
             self.freeFunctionTemplateSpecContent = _specContent
         else:
-            self.specContent += _specContent
-        return _genSpecial
+            self.specContent.append(_specContent)
+        return "".join(_genSpecial)
+
+    def _generateMethodIdentifierAccessors(self, className, methodName):
+        """
+        Generate the accessors of the method call data structure on the method identifier, those are used by the generic
+        dupe helpers of FSeam.hpp (dupeVirtualClock, dupeVirtualSleep...) in order to get the return value / arguments of a
+        call without having to know the generated data structure.
+        The accessors are kept on a single line as the FreeFunction identifiers are re-used as is at each generation.
+        """
+        _methodMapping = self.functionSignatureMapping[className][methodName]
+        if _methodMapping["isConstructorOrDestructor"] is True:
+            return ""
+        _dataType = "FSeam::" + className + "Data"
+        _accessors = " using Data = " + _dataType + ";"
+        if _methodMapping["rtnType"].replace("&", "").replace("static ", "") != "void":
+            _accessors += " static auto &returnValue(void *d) { return static_cast<Data *>(d)->" + methodName + RETURN_SUFFIX + "; }"
+        _namedParams = [p for p in _methodMapping["params"] if p["name"] not in ["&", "", None, "*", "&&"]]
+        _params = [methodName + "_" + p["name"] + PARAM_SUFFIX for p in _namedParams]
+        _accessors += " using ArgsCompare = std::tuple<" + ", ".join([self._argCompareType(p["type"]) for p in _namedParams]) + ">;"
+        if len(_params) > 0:
+            _accessors += " static auto args(void *d) { return std::tie(" + \
+                          ", ".join(["static_cast<Data *>(d)->" + p for p in _params]) + "); } "
+        else:
+            _accessors += " static auto args(void *) { return std::tuple<>(); } "
+        return _accessors
+
+    def _isUsed(self, className, methodName):
+        return self.usage is None or (className + "::" + methodName.replace("~", "Destructor_")) in self.usage["methods"]
+
+    def _hasDupeReturnSpecialization(self, className, methodName):
+        _methodMapping = self.functionSignatureMapping[className][methodName]
+        _returnType = _methodMapping["rtnType"].replace("static ", "")
+        # an awaitable can't be copied into the dupe, its dupeAsyncReturn creates a new one at each call
+        return _returnType != "void" and re.search(self.asyncReturnRegex, _returnType) is None and \
+            self._isUsed(className, methodName)
+
+    def _getExpectArgSpecializations(self, className, methodName):
+        """
+        :return: calling comparators (None for the expectArg without calling comparator) for which the expectArg of the
+                 method is specialized
+        """
+        if len(self.functionSignatureMapping[className][methodName]["params"]) == 0 or not self._isUsed(className, methodName):
+            return []
+        if self.usage is None:
+            return [None] + CALLED_COMPARATORS
+        return [None] + [c for c in CALLED_COMPARATORS if c in self.usage["comparators"]]
+
+    def _generateMethodIdentifierSpecializations(self, className, methodName):
+        """
+        Generate the list of generated specializations on the method identifier, used by FSeam.hpp in order to call
+        either the generated specialization or the generic implementation of dupeReturn / expectArg
+        """
+        _comparators = ["void" if c is None else c for c in self._getExpectArgSpecializations(className, methodName)]
+        _dupeReturn = "true" if self._hasDupeReturnSpecialization(className, methodName) else "false"
+        return "using Specializations = FSeam::SpecializedExpectations<" + ", ".join(_comparators) + ">; " + \
+               "static constexpr bool DUPE_RETURN_SPECIALIZED = " + _dupeReturn + "; "
 
     def _getCurrentFreeFunctionDataContent(self, content):
         indexBegin = content.find("struct FreeFunctionData {\n") + len("struct FreeFunctionData {\n")
@@ -379,17 +515,42 @@ class FSeamerFile:
         else:
             _content += INDENT + "FSeam::" + className + "Data data {};\n\n"
         for p in self.functionSignatureMapping[className][methodName]["params"]:
-            _content += INDENT + "if (std::is_copy_constructible<std::decay<" + p["type"].replace("& &", "&&") + ">>())\n"
-            _content += INDENT2 + "data." + methodName + "_" + p["name"] + PARAM_SUFFIX + " = " + p["name"] + ";\n"
+            _paramType = p["type"].replace("& &", "&&")
+            _paramData = "data." + methodName + "_" + p["name"] + PARAM_SUFFIX
+            if "&" in _paramType:
+                _content += INDENT + _paramData + " = " + p["name"] + ";\n"
+            else:
+                _content += INDENT + _paramData + " = FSeam::capture<" + _paramType + ">(" + p["name"] + ");\n"
         _content += INDENT + "mockVerifier->invokeDupedMethod(__func__, &data);\n"
         _content += INDENT + "mockVerifier->methodCall(__func__, &data);\n"
         if 'void' != returnType and self.functionSignatureMapping[className][methodName]["isConstructorOrDestructor"] is False:
-            _content += INDENT + "return data." + methodName + "_ReturnValue;"
+            if "&" in returnType:
+                _content += INDENT + "return data." + methodName + "_ReturnValue;"
+            else:
+                # moved out, the return value can be move-only (std::future, awaitable task types...)
+                _content += INDENT + "return std::move(data." + methodName + "_ReturnValue);"
         return _content
 
+    @staticmethod
+    def _compareType(paramType):
+        """
+        Type used to compare an argument in the expectations, argument passed by value are compared depending on how they
+        are captured (copied, or borrowed / captured in arena and then compared as const reference), see FSeam::CaptureTraits
+        """
+        if "&" in paramType:
+            return paramType
+        return "FSeam::CaptureCompare<" + paramType + ">"
+
+    @staticmethod
+    def _argCompareType(paramType):
+        _compareType = FSeamerFile._compareType(paramType)
+        if "& &" in _compareType:
+            _compareType = "std::reference_wrapper<" + _compareType.replace("& &", "") + ">"
+        return _compareType
+
     @staticmethod
     def _generateSpecializationVerifyArg(className, methodName, methodMapping, comparator=None):
-        _gen = "template <> void FSeam::MockClassVerifier::expectArg<FSeam::" + className + "::" + methodName + ", "
+        _gen = "template <> void FSeam::MockClassVerifier::expectArgSpecialized<FSeam::" + className + "::" + methodName + ", "
         for _ in methodMapping["params"]:
             _gen += "FSeam::ArgComp, "
         if comparator is not None:
@@ -401,12 +562,20 @@ class FSeamerFile:
         if comparator is not None:
             _gen += comparator + " comp"
         _gen += ") {\n"
+        _gen += INDENT + "if (this->isDeferringExpectations()) {\n"
+        _gen += INDENT2 + "this->registerDeferredExpectation<FSeam::" + className + "::" + methodName
+        for param in methodMapping["params"]:
+            _gen += ", " + FSeamerFile._compareType(param["type"]).replace("& &", "const &")
+        _gen += ">(" + ("comp" if comparator is not None else "FSeam::AtLeast{1}")
+        for param in methodMapping["params"]:
+            _gen += ", " + param["name"]
+        _gen += ");\n"
+        _gen += INDENT2 + "return;\n"
+        _gen += INDENT + "}\n"
         _gen += INDENT + "auto expectationChecker = [=](void *methodCallData) { \n"
         _gen += INDENT2 + "bool argCheck = true;\n"
         for param in methodMapping["params"]:
-            _paramValue = param["type"]
-            if "& &" in _paramValue:
-                _paramValue = "std::reference_wrapper<" + _paramValue.replace("& &", "") + ">"
+            _paramValue = FSeamerFile._argCompareType(param["type"])
             _gen += INDENT2 + "argCheck &= " + param["name"] + ".compare<" + _paramValue + ">(*static_cast<FSeam::" + className + "Data *>(methodCallData)->" + methodName + "_" + param[
                         "name"] + PARAM_SUFFIX + ");\n"
         _gen += INDENT2 + "return argCheck;\n"
@@ -420,55 +589,133 @@ class FSeamerFile:
         return _gen
 
     @staticmethod
-    def _clearDataStructureData(content, className):
-        sb, sm, se = content.partition(CLASS_START_FMT.format(className))
-        eb, em, ee = content.partition(CLASS_END_FMT.format(className))
-        return sb + ee if sm is not "" and em is not "" else content
+    def _clearBlocks(content, startRegex, endFmt, names):
+        """
+        Remove the generated blocks (from the start marker to the end marker) of the given names in a single pass on the
+        content
+        :param startRegex: regex of the start marker of a block, capturing the name of the block
+        :param endFmt: end marker of a block, formatted with the name of the block
+        :param names: names of the blocks to remove
+        :return: content without the blocks
+        """
+        _names = set(names)
+        _kept = []
+        _position = 0
+        for match in re.finditer(startRegex, content):
+            if match.start() < _position or match.group(1) not in _names:
+                continue
+            _end = content.find(endFmt.format(match.group(1)), match.end())
+            if _end < 0:
+                continue
+            _kept.append(content[_position:match.start()])
+            _position = _end + len(endFmt.format(match.group(1)))
+        _kept.append(content[_position:])
+        return "".join(_kept)
 
     @staticmethod
-    def _clearSpecialization(content, className):
-        indexBegin = content.find("\n\n// Duping/Expectations specializations for " + className + "\n")
-        indexEnd = content.find("// End of Specialization for " + className + "\n\n") + len(
-            "// End of Specialization for " + className + "\n\n")
-        if indexBegin > 0 and indexEnd > len("// End of Specialization for " + className + "\n\n"):
-            content = content[0: indexBegin] + content[indexEnd:]
-        return content
+    def _clearDataStructureData(content, classNames):
+        return FSeamerFile._clearBlocks(content, DATA_BLOCK_START_REGEX, CLASS_END_FMT, classNames)
 
     @staticmethod
-    def _clearSpecializationFreeFunction(content, freeFunctionName):
-        indexBegin = content.find("// Generated duping for method " + FREE_FUNC_FAKE_CLASS + "::" + freeFunctionName + " begin\n")
-        strEnd = "// Generated duping for method " + FREE_FUNC_FAKE_CLASS + "::" + freeFunctionName + " end\n"
-        indexEnd = content.find(strEnd) + len(strEnd)
-        if indexBegin > 0 and indexEnd > len(strEnd):
-            content = content[0: indexBegin] + content[indexEnd:]
-        return content
+    def _clearSpecialization(content, classNames, freeFunctionNames):
+        content = FSeamerFile._clearBlocks(content, SPEC_BLOCK_START_REGEX, SPEC_BLOCK_END_FMT, classNames)
+        return FSeamerFile._clearBlocks(content, FREE_FUNC_SPEC_BLOCK_START_REGEX, FREE_FUNC_SPEC_BLOCK_END_FMT,
+                                        freeFunctionNames)
 
 
-def generateFSeamFile(filePath, destinationFolder, forceGeneration=False):
+def clangFrontend(options):
+    """
+    :param options: generator options (-I<folder>, --pch=<file>, --libclang=<file>, --clang-arg=<arg>)
+    :return: frontend parsing the header with libclang
+    """
+    import FSeamClangFrontend
+    _includes = [o[2:] for o in options if o.startswith("-I")]
+    _pch = next((o.split("=", 1)[1] for o in options if o.startswith("--pch=")), None)
+    _libclang = next((o.split("=", 1)[1] for o in options if o.startswith("--libclang=")), None)
+    _extraArgs = [o.split("=", 1)[1] for o in options if o.startswith("--clang-arg=")]
+    return lambda headerPath: FSeamClangFrontend.ClangHeader(headerPath, _includes, _pch, _extraArgs, _libclang)
+
+
+def scanUsage(usageFiles):
+    """
+    :param usageFiles: test files using the generated mocks
+    :return: methods (Class::method) and calling comparators referenced in the files
+    """
+    _usage = {"methods": set(), "comparators": set()}
+    for usageFile in usageFiles:
+        with open(usageFile, "r") as _file:
+            _content = _file.read()
+        _usage["methods"].update([m[0] + "::" + m[1].replace("~", "Destructor_") for m in re.findall(USAGE_METHOD_REGEX, _content)])
+        _usage["comparators"].update(["FSeam::" + c for c in re.findall(USAGE_COMPARATOR_REGEX, _content)])
+    # expectArgTable register the rows with any calling comparator
+    if "FSeam::expectArgTable" in _usage["comparators"]:
+        _usage["comparators"].update(CALLED_COMPARATORS)
+    return _usage
+
+
+def writeDepFile(depFilePath, target, dependencies):
+    """
+    Write a Make / Ninja dependency file (DEPFILE of the add_custom_command generating the mock)
+
+    :param depFilePath: path of the dependency file
+    :param target: generated file
+    :param dependencies: files the generated file depends on
+    """
+    def _escape(path):
+        return path.replace("\\", "/").replace(" ", "\\ ").replace("#", "\\#").replace("$", "$$")
+
+    _content = _escape(os.path.abspath(target)) + ":"
+    for dependency in dependencies:
+        _content += " \\\n  " + _escape(os.path.abspath(dependency))
+    _content += "\n"
+    with open(depFilePath, "w") as _depFile:
+        _depFile.write(_content)
+
+
+def generateFSeamFile(filePath, destinationFolder, forceGeneration=False, frontend=None, usageFiles=None,
+                      includeFolders=None, depFile=None, asyncReturnTypes=None, output=None):
     """
     Client exposed method, will create the FSeam mock file and fill them with the content provided by the FSeam parser
 
-    :param filePath: path of the cpp header file to parse in order to generate the seam mock
+    :param filePath: path of the cpp header file to parse in order to generate the seam mock, it can be followed by
+                     method selectors (header.hh:Class::method,Class::otherMethod) in order to mock only those methods
     :param destinationFolder: folder in which the generated folder will be created
     :param forceGeneration: if there are no need to generate the FSeam mock (mock, apparently, up to date) this flag
                             make it able to bypass those check and to generate brand new mock anyway (the FSeamMockData.hpp
                             won't be deleted, the usual process of removing only the part re-generated will stays as is)
                             by default, this flag is set to False
+    :param frontend: parser of the header file (see FSeamerFile), CppHeaderParser by default
+    :param usageFiles: test files using the mock, if provided the specializations are generated only for the methods
+                       and comparators referenced in those files
+    :param includeFolders: include folders in which the includes of the header are resolved (dependencies of the mock)
+    :param depFile: if provided, dependency file listing the header, the headers it includes and the usage files
+    :param asyncReturnTypes: awaitable templates having FSeam::AsyncReturn traits (see FSeamerFile)
+    :param output: stream on which the generation is reported, sys.stdout by default
     :return: no return
     """
+    _methodSelectors = None
+    _selectorMatch = re.match(METHOD_SELECTOR_REGEX, filePath)
+    if _selectorMatch:
+        filePath = _selectorMatch.group(1)
+        _methodSelectors = _selectorMatch.group(2).split(",")
+
     if not str.endswith(filePath, ".hh") and not str.endswith(filePath, ".hpp") and not str.endswith(filePath, ".h"):
         raise NameError("Error file " + filePath + " is not a .hh (or .hpp .h) file")
 
-    _fSeamerFile = FSeamerFile(filePath)
+    _fSeamerFile = FSeamerFile(filePath, _methodSelectors, frontend, scanUsage(usageFiles) if usageFiles is not None else None,
+                               asyncReturnTypes, output)
     _fileName = _fSeamerFile.getFSeamGeneratedFileName()
     _fileFSeamPath = os.path.normpath(destinationFolder + "/" + _fileName)
-    if not forceGeneration and _fSeamerFile.isSeamFileUpToDate(_fileFSeamPath):
-        print("FSeam file is already generated at path " + _fileFSeamPath)
+    _dependencies = _fSeamerFile.getDependencies(includeFolders) + (usageFiles or [])
+    if depFile is not None:
+        writeDepFile(depFile, _fileFSeamPath, _dependencies)
+    if not forceGeneration and _fSeamerFile.isSeamFileUpToDate(_fileFSeamPath, _dependencies):
+        print("FSeam file is already generated at path " + _fileFSeamPath, file=output)
         return
 
     with open(_fileFSeamPath, "w") as _fileCreated:
         _fileCreated.write(_fSeamerFile.seamParse())
-    print("FSeam generated file " + _fileName + " at " + os.path.abspath(destinationFolder))
+    print("FSeam generated file " + _fileName + " at " + os.path.abspath(destinationFolder), file=output)
 
     _fileCreatedMockDataPath = os.path.normpath(destinationFolder + "/FSeamMockData.hpp")
     _fileCreatedMockDataContent = ""
@@ -477,7 +724,7 @@ def generateFSeamFile(filePath, destinationFolder, forceGeneration=False):
             _fileCreatedMockDataContent = _fileCreatedMockData.read().replace(LOCKING_FOOTER, "")
     with open(_fileCreatedMockDataPath, "w") as _fileCreatedMockData:
         _fileCreatedMockData.write(_fSeamerFile.generateDataStructureContent(_fileCreatedMockDataContent))
-    print("FSeam generated file FSeamMockData.hpp at " + os.path.abspath(destinationFolder))
+    print("FSeam generated file FSeamMockData.hpp at " + os.path.abspath(destinationFolder), file=output)
     _fileCreatedSpecializationPath = os.path.normpath(destinationFolder + "/FSeamSpecialization.cpp")
     _fileCreatedSpecializationContent = ""
     if os.path.exists(_fileCreatedSpecializationPath):
@@ -485,14 +732,56 @@ def generateFSeamFile(filePath, destinationFolder, forceGeneration=False):
             _fileCreatedSpecializationContent = _fileCreatedSpecData.read()
     with open(_fileCreatedSpecializationPath, "w") as _fileCreatedSpecData:
         _fileCreatedSpecData.write(_fSeamerFile.getSpecializationContent(_fileCreatedSpecializationContent))
-    print("FSeam generated file FSeamSpecialization.cpp at " + os.path.abspath(destinationFolder))
+    print("FSeam generated file FSeamSpecialization.cpp at " + os.path.abspath(destinationFolder), file=output)
 
 
-if __name__ == '__main__':
-    _args = sys.argv[1:]
+def generateFromCommandLine(argv, parsedHeaders=None, output=None):
+    """
+    Generate the mock of a header from the command line arguments of the generator
+
+    :param argv: command line arguments (header to mock, destination folder, options)
+    :param parsedHeaders: cache of the parsed headers (see FSeamWatch.ParsedHeaders) used instead of parsing the header
+    :param output: stream on which the generation is reported, sys.stdout by default
+    """
+    _options = [a for a in argv if a.startswith("-")]
+    _args = [a for a in argv if not a.startswith("-")]
     if len(_args) < 2:
         raise NameError("Error missing argument for generation")
     _forceGeneration = True
     if len(_args) > 2:
-        _forceGeneration = _args[2]
-    generateFSeamFile(_args[0], _args[1], _forceGeneration)
+        # CMake boolean (FSEAM_FORCE_GENERATION)
+        _forceGeneration = _args[2].upper() not in ["0", "OFF", "FALSE", "NO", "N", "IGNORE", ""]
+    _frontend = None
+    if "--frontend=clang" in _options:
+        _frontend = clangFrontend(_options)
+    if parsedHeaders is not None:
+        _frontend = parsedHeaders.frontend(_frontend, _options)
+    _usageFiles = None
+    if any(o.startswith("--usage") for o in _options):
+        _usageFiles = [o.split("=", 1)[1] for o in _options if o.startswith("--usage=")]
+        for usageList in [o.split("=", 1)[1] for o in _options if o.startswith("--usage-list=")]:
+            with open(usageList, "r") as _usageListFile:
+                _usageFiles += [l.strip() for l in _usageListFile if l.strip()]
+    _includeFolders = [o[2:] for o in _options if o.startswith("-I")]
+    _depFile = next((o.split("=", 1)[1] for o in _options if o.startswith("--depfile=")), None)
+    _asyncReturnTypes = [o.split("=", 1)[1] for o in _options if o.startswith("--async-return=")]
+    generateFSeamFile(_args[0], _args[1], _forceGeneration, _frontend, _usageFiles, _includeFolders, _depFile,
+                      _asyncReturnTypes, output)
+
+
+if __name__ == '__main__':
+    _daemon = next((o.split("=", 1)[1] for o in sys.argv[1:] if o.startswith("--daemon=")), None)
+    _argv = [a for a in sys.argv[1:] if a != "--watch" and not a.startswith("--daemon=")]
+    if "--watch" in sys.argv[1:]:
+        import FSeamWatch
+        FSeamWatch.WatchDaemon(_daemon or FSeamWatch.DEFAULT_SOCKET).serveForever()
+    elif _daemon is None:
+        generateFromCommandLine(_argv)
+    else:
+        import FSeamWatch
+        _status = FSeamWatch.request(_daemon, _argv)
+        if _status is None:
+            # no daemon listening, generated by this process
+            generateFromCommandLine(_argv)
+        elif _status != 0:
+            sys.exit(_status)
@@ -0,0 +1,295 @@
+#! /usr/bin/env python
+# MIT License
+#
+# Copyright (c) 2019 Quentin Balland
+# Project : https://github.com/FreeYourSoul/FSeam
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""
+Build time benchmark of FSeam: a project of N mocked headers (M methods of P parameters each) is synthesized and built
+through addFSeamTests (FSeamModule.cmake), the build steps are timed by a launcher (RULE_LAUNCH_CUSTOM / COMPILE / LINK).
+
+Recorded: generation time per header, compile time per translation unit, link time, and the size of the generated
+files (FSeamMockData.hpp, FSeamSpecialization.cpp, <Header>.fseam.cc) and of their objects.
+With --baseline=<report.json>, the report is compared with a previous one: exit status 1 if a metric regressed.
+
+    FSeamBuildBenchmark.py --headers=20 --methods=30 --params=3 --output=report.json
+    FSeamBuildBenchmark.py --headers=20 --methods=30 --params=3 --baseline=report.json
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+FSEAM_ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+PARAMETER_TYPES = ["int", "const std::string &", "double", "bool", "const std::vector<int> &"]
+PARAMETER_VALUES = ["1", "std::string(\"value\")", "2.0", "true", "std::vector<int>{1, 2}"]
+GENERATED_FILES = ["FSeamMockData.hpp", "FSeamSpecialization.cpp"]
+# time regressions smaller than this are measurement noise
+TIME_SLACK_SECONDS = 0.05
+
+PROJECT_CMAKE = """cmake_minimum_required(VERSION 3.5)
+project(fseamBenchmark CXX)
+
+set(CMAKE_CXX_STANDARD 17)
+set(FSEAM_BUILD_TESTS OFF CACHE BOOL "" FORCE)
+add_subdirectory({fseamRoot} fseam)
+
+# every step of the build is timed by the benchmark launcher
+set_property(GLOBAL PROPERTY RULE_LAUNCH_CUSTOM "{launcher} custom")
+set_property(GLOBAL PROPERTY RULE_LAUNCH_COMPILE "{launcher} compile")
+set_property(GLOBAL PROPERTY RULE_LAUNCH_LINK "{launcher} link")
+
+include({fseamRoot}/cmake/FSeamModule.cmake)
+set(FSEAM_GENERATOR_COMMMAND ${{PYTHON_EXECUTABLE}} {fseamRoot}/Generator/FSeamerFile.py)
+
+addFSeamTests(
+        DESTINATION_TARGET benchmarkFSeam
+        FILES_AS_SOURCE {sources}
+        FOLDER_INCLUDES ${{CMAKE_CURRENT_SOURCE_DIR}}/src
+        TST_SRC {tests}
+        TO_MOCK {headers})
+"""
+
+
+def _cmakePath(path):
+    return path.replace("\\", "/")
+
+
+def _parameters(params, values=False):
+    if values:
+        return ", ".join(PARAMETER_VALUES[p % len(PARAMETER_VALUES)] for p in range(params))
+    return ", ".join(PARAMETER_TYPES[p % len(PARAMETER_TYPES)] + " p" + str(p) for p in range(params))
+
+
+def synthesizeProject(sourceFolder, launcher, headers, methods, params):
+    """
+    Write the benchmarked project: a class per header (Mocked<n>.hh, its implementation is replaced by the mock), and
+    a test file per header using its mock (dupeReturn, expectArg and verify on the first method)
+    """
+    _src = os.path.join(sourceFolder, "src")
+    os.makedirs(_src, exist_ok=True)
+    _files = {"headers": [], "sources": [], "tests": [os.path.join(sourceFolder, "testMain.cpp")]}
+    with open(_files["tests"][0], "w") as _main:
+        _main.write("#define CATCH_CONFIG_MAIN\n#include <catch2/catch.hpp>\n")
+    for h in range(headers):
+        _className = "Mocked" + str(h)
+        _header = os.path.join(_src, _className + ".hh")
+        with open(_header, "w") as _file:
+            _file.write("#pragma once\n#include <string>\n#include <vector>\n\nnamespace bench {\n"
+                        "class " + _className + " {\npublic:\n")
+            for m in range(methods):
+                _file.write("    int method" + str(m) + "(" + _parameters(params) + ");\n")
+            _file.write("};\n}\n")
+        _source = os.path.join(_src, _className + ".cpp")
+        with open(_source, "w") as _file:
+            _file.write("#include \"" + _className + ".hh\"\n\n")
+            for m in range(methods):
+                _file.write("int bench::" + _className + "::method" + str(m) + "(" + _parameters(params) + ") { return "
+                            + str(m) + "; }\n")
+        _test = os.path.join(sourceFolder, _className + "Test.cpp")
+        with open(_test, "w") as _file:
+            _file.write("#include <catch2/catch.hpp>\n#include <FSeam.hpp>\n#include <FSeamMockData.hpp>\n"
+                        "#include <" + _className + ".hh>\n\n"
+                        "TEST_CASE(\"" + _className + "\") {\n"
+                        "    bench::" + _className + " mocked;\n"
+                        "    auto fseamMock = FSeam::get(&mocked);\n"
+                        "    fseamMock->dupeReturn<FSeam::" + _className + "::method0>(42);\n")
+            if params > 0:
+                _matchers = ", ".join(["FSeam::Eq(1)"] + ["FSeam::Any()"] * (params - 1))
+                _file.write("    fseamMock->expectArg<FSeam::" + _className + "::method0>(" + _matchers + ", FSeam::VerifyCompare{1});\n")
+            _file.write("    REQUIRE(mocked.method0(" + _parameters(params, True) + ") == 42);\n"
+                        "    REQUIRE(fseamMock->verify(FSeam::" + _className + "::method0::NAME, 1));\n"
+                        "    FSeam::MockVerifier::cleanUp();\n}\n")
+        _files["headers"].append(_header)
+        _files["sources"].append(_source)
+        _files["tests"].append(_test)
+    with open(os.path.join(sourceFolder, "CMakeLists.txt"), "w") as _cmake:
+        _cmake.write(PROJECT_CMAKE.format(fseamRoot=_cmakePath(FSEAM_ROOT), launcher=_cmakePath(launcher),
+                                          sources=" ".join(_cmakePath(s) for s in _files["sources"]),
+                                          tests=" ".join(_cmakePath(t) for t in _files["tests"]),
+                                          headers=" ".join(_cmakePath(h) for h in _files["headers"])))
+    return _files
+
+
+def record(logPath, kind, command):
+    """
+    Launcher mode: run the build step and append its duration to the log
+    """
+    _begin = time.perf_counter()
+    _status = subprocess.call(command)
+    _seconds = time.perf_counter() - _begin
+    _name = None
+    if kind == "compile" and "-c" in command:
+        _name = os.path.basename(command[command.index("-c") + 1])
+    elif kind == "link" and "-o" in command:
+        _name = os.path.basename(command[command.index("-o") + 1])
+    elif kind == "link":
+        _name = next((os.path.basename(a) for a in command if a.endswith((".a", ".lib"))), None)
+    elif kind == "custom" and any(a.endswith("FSeamerFile.py") for a in command):
+        kind = "generation"
+        _name = next(os.path.basename(a.split(":")[0]) for a in command if a.split(":")[0].endswith((".hh", ".hpp", ".h")))
+    if _name is not None:
+        with open(logPath, "a") as _log:
+            _log.write(json.dumps({"kind": kind, "name": _name, "seconds": _seconds}) + "\n")
+    return _status
+
+
+def _objectSizes(buildFolder, names):
+    _sizes = {}
+    for root, _, files in os.walk(buildFolder):
+        for f in files:
+            if f.endswith((".o", ".obj")) and os.path.splitext(f)[0] in names:
+                _sizes[f] = os.path.getsize(os.path.join(root, f))
+    return _sizes
+
+
+def runBenchmark(arguments):
+    _sourceFolder = os.path.join(arguments.work_dir, "src")
+    _buildFolder = os.path.join(arguments.work_dir, "build")
+    _log = os.path.join(arguments.work_dir, "steps.log")
+    # only the folders of the benchmark are removed (the work dir can be a build folder)
+    for folder in [_sourceFolder, _buildFolder]:
+        if os.path.isdir(folder):
+            shutil.rmtree(folder)
+    if os.path.exists(_log):
+        os.remove(_log)
+    _launcher = " ".join([sys.executable, os.path.abspath(__file__), "--record=" + _log])
+    synthesizeProject(_sourceFolder, _launcher, arguments.headers, arguments.methods, arguments.params)
+
+    _configure = [arguments.cmake, "-S", _sourceFolder, "-B", _buildFolder, "-DCMAKE_BUILD_TYPE=" + arguments.build_type,
+                  "-DPYTHON_EXECUTABLE=" + sys.executable]
+    if arguments.generator:
+        _configure += ["-G", arguments.generator]
+    if arguments.prune:
+        _configure.append("-DFSEAM_PRUNE_SPECIALIZATIONS=ON")
+    _configure += arguments.cmake_arg or []
+    _begin = time.perf_counter()
+    subprocess.check_call(_configure, stdout=subprocess.DEVNULL)
+    _configureSeconds = time.perf_counter() - _begin
+    _begin = time.perf_counter()
+    subprocess.check_call([arguments.cmake, "--build", _buildFolder, "-j", str(arguments.jobs)], stdout=subprocess.DEVNULL)
+    _buildSeconds = time.perf_counter() - _begin
+
+    _steps = {"generation": {}, "compile": {}, "link": {}}
+    with open(_log, "r") as _logFile:
+        for line in _logFile:
+            _step = json.loads(line)
+            _steps[_step["kind"]][_step["name"]] = round(_step["seconds"], 4)
+    _generatedFiles = GENERATED_FILES + sorted(f for f in os.listdir(_buildFolder) if f.endswith(".fseam.cc"))
+    _report = {
+        "config": {"headers": arguments.headers, "methods": arguments.methods, "params": arguments.params,
+                   "prune": arguments.prune, "build_type": arguments.build_type, "jobs": arguments.jobs},
+        "configure_seconds": round(_configureSeconds, 4),
+        "build_seconds": round(_buildSeconds, 4),
+        "generation": _steps["generation"],
+        "compile": _steps["compile"],
+        "link": _steps["link"],
+        "generated_size": {f: os.path.getsize(os.path.join(_buildFolder, f)) for f in _generatedFiles},
+        "object_size": _objectSizes(_buildFolder, _generatedFiles),
+    }
+    _report["totals"] = {
+        "generation_seconds": round(sum(_steps["generation"].values()), 4),
+        "compile_seconds": round(sum(_steps["compile"].values()), 4),
+        "compile_max_seconds": max(_steps["compile"].values(), default=0),
+        "link_seconds": round(sum(_steps["link"].values()), 4),
+        "generated_bytes": sum(_report["generated_size"].values()),
+        "object_bytes": sum(_report["object_size"].values()),
+    }
+    return _report
+
+
+def printReport(report, out=sys.stdout):
+    _config = report["config"]
+    print("FSeam build benchmark : %d headers, %d methods, %d params%s" % (
+        _config["headers"], _config["methods"], _config["params"], " (pruned specializations)" if _config["prune"] else ""),
+        file=out)
+    print("  configure %.2fs, build %.2fs (-j%d)" % (report["configure_seconds"], report["build_seconds"], _config["jobs"]),
+          file=out)
+    for metric, value in report["totals"].items():
+        print("  %-22s %s" % (metric, value), file=out)
+    for name in sorted(report["compile"], key=report["compile"].get, reverse=True)[:5]:
+        print("  compile %-40s %.2fs" % (name, report["compile"][name]), file=out)
+    for name in GENERATED_FILES:
+        print("  %-48s %d bytes" % (name, report["generated_size"].get(name, 0)), file=out)
+
+
+def compareReports(report, baseline, tolerance, out=sys.stdout):
+    """
+    :return: metrics (totals, and the compile time / size of the generated files) worse than the baseline by more
+             than the tolerance
+    """
+    if report["config"] != baseline["config"]:
+        print("FSeam build benchmark : baseline made with another configuration " + json.dumps(baseline["config"]), file=out)
+        return ["config"]
+    _metrics = [("totals", m) for m in report["totals"]] + \
+               [("generated_size", f) for f in report["generated_size"]] + \
+               [("object_size", f) for f in report["object_size"]]
+    _regressions = []
+    for section, name in _metrics:
+        _value, _reference = report[section][name], baseline.get(section, {}).get(name)
+        if _reference is None:
+            continue
+        _slack = TIME_SLACK_SECONDS if name.endswith("seconds") else 0
+        if _value > _reference * (1 + tolerance) + _slack:
+            _regressions.append(section + "." + name)
+            print("  REGRESSION %s.%s : %s (baseline %s)" % (section, name, _value, _reference), file=out)
+    return _regressions
+
+
+def main(argv):
+    if argv and argv[0].startswith("--record="):
+        return record(argv[0].split("=", 1)[1], argv[1], argv[2:])
+    _parser = argparse.ArgumentParser(description="FSeam build time benchmark")
+    _parser.add_argument("--headers", type=int, default=10, help="number of mocked headers")
+    _parser.add_argument("--methods", type=int, default=20, help="number of methods per mocked class")
+    _parser.add_argument("--params", type=int, default=3, help="number of parameters per method")
+    _parser.add_argument("--prune", action="store_true", help="FSEAM_PRUNE_SPECIALIZATIONS=ON")
+    _parser.add_argument("--work-dir", default=os.path.join(os.getcwd(), "fseam_benchmark"))
+    _parser.add_argument("--generator", default=None, help="CMake generator (CMake default if not set)")
+    _parser.add_argument("--build-type", default="Debug")
+    _parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1)
+    _parser.add_argument("--cmake", default="cmake")
+    _parser.add_argument("--cmake-arg", action="append", help="additional argument of the configuration")
+    _parser.add_argument("--output", default=None, help="write the report (json) in this file")
+    _parser.add_argument("--baseline", default=None, help="report to compare with, exit status 1 on regression")
+    _parser.add_argument("--tolerance", type=float, default=0.25, help="relative regression tolerated")
+    _arguments = _parser.parse_args(argv)
+    _arguments.work_dir = os.path.abspath(_arguments.work_dir)
+    os.makedirs(_arguments.work_dir, exist_ok=True)
+
+    _report = runBenchmark(_arguments)
+    printReport(_report)
+    if _arguments.output:
+        with open(_arguments.output, "w") as _output:
+            json.dump(_report, _output, indent=2, sort_keys=True)
+    if _arguments.baseline:
+        with open(_arguments.baseline, "r") as _baselineFile:
+            if compareReports(_report, json.load(_baselineFile), _arguments.tolerance):
+                return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -1,12 +1,34 @@
 cmake_minimum_required(VERSION 3.5)
+if (POLICY CMP0116)
+    # the dependency files written by the generator contain absolute paths
+    cmake_policy(SET CMP0116 NEW)
+endif ()
 
 set(FSEAM_GENERATOR_DESTINATION ${CMAKE_CURRENT_BINARY_DIR})
 
-option(FSEAM_FORCE_GENERATION "Force the generation of the file " ON)
+option(FSEAM_FORCE_GENERATION "Force the generation of the file (otherwise skipped if newer than the header and its includes)" ON)
 option(FSEAM_CLEANUP_DATA "Cleanup the data file  " OFF)
 
 option(FSEAM_USE_CATCH2 "fseam catch2 usage" ON)
 option(FSEAM_USE_GTEST "fseam catch2 usage" OFF)
+set(FSEAM_GENERATOR_FRONTEND "CppHeaderParser" CACHE STRING "parser of the headers to mock (CppHeaderParser or clang)")
+set(FSEAM_CLANG_PCH "" CACHE FILEPATH "precompiled preamble reused by the clang frontend (created if it doesn't exist)")
+option(FSEAM_PRUNE_SPECIALIZATIONS "Generate the dupeReturn / expectArg specializations only for the methods used by the tests" OFF)
+set(FSEAM_ASYNC_RETURN_TYPES "" CACHE STRING "awaitable templates (namespace::Task) with FSeam::AsyncReturn traits, in addition to std::future and std::shared_future")
+set(FSEAM_GENERATOR_DAEMON "" CACHE FILEPATH "socket of the FSeam watch daemon (FSeamWatch target) used for the generation if running")
+option(FSEAM_HEADER_ONLY "Link the tests against the header only FSeam target instead of the compiled FSeam-static" OFF)
+
+# the generator lists the headers included by the mocked header in a dependency file (DEPFILE of the generation),
+# supported by Ninja and by the Makefiles generators since CMake 3.20
+if (CMAKE_GENERATOR MATCHES "Ninja" OR (CMAKE_GENERATOR MATCHES "Makefiles" AND NOT CMAKE_VERSION VERSION_LESS 3.20))
+    set(FSEAM_GENERATOR_DEPFILE ON)
+endif ()
+
+if (FSEAM_HEADER_ONLY)
+    set(FSEAM_RUNTIME_TARGET FSeam)
+else ()
+    set(FSEAM_RUNTIME_TARGET FSeam-static)
+endif ()
 
 if (FSEAM_USE_CATCH2)
     find_package(Catch2 REQUIRED)
@@ -18,11 +40,23 @@ endif ()
 
 find_package(PythonInterp 3 REQUIRED)
 
+if (NOT CMAKE_OBJCOPY)
+    find_program(CMAKE_OBJCOPY objcopy)
+endif ()
+
 if (NOT FSEAM_GENERATOR_COMMMAND)
     find_file(FILE_FSEAMER_PY FSeamerFile.py)
     set(FSEAM_GENERATOR_COMMMAND ${PYTHON_EXECUTABLE} ${FILE_FSEAMER_PY})
 endif ()
 
+if (FSEAM_GENERATOR_DAEMON AND NOT TARGET FSeamWatch)
+    # persistent generator re-generating the mocks when their header is saved (to be run in its own terminal)
+    add_custom_target(FSeamWatch
+            COMMAND ${FSEAM_GENERATOR_COMMMAND} --watch --daemon=${FSEAM_GENERATOR_DAEMON}
+            USES_TERMINAL
+            COMMENT "FSeam watch daemon listening on ${FSEAM_GENERATOR_DAEMON}")
+endif ()
+
 
 include(CTest)
 
@@ -34,29 +68,131 @@ include(CTest)
 function (setup_FSeam_test)
 
 #    message(WARNING "BEFORE Source compiled ${FSEAM_TEST_SRC}")
-    foreach (fileToMockPath ${ADDFSEAMTESTS_TO_MOCK})
+    # TO_MOCK entries can select methods of a header (Header.hh:Class::method), selectors of a same header are merged
+    set(FSEAM_HEADERS_TO_MOCK "")
+    foreach (toMock ${ADDFSEAMTESTS_TO_MOCK})
+        if (toMock MATCHES "^(.*\\.(hh|hpp|h)):(.+)$")
+            set(fileToMockPath ${CMAKE_MATCH_1})
+            list(APPEND FSEAM_SELECTORS_${fileToMockPath} ${CMAKE_MATCH_3})
+        else ()
+            set(fileToMockPath ${toMock})
+            set(FSEAM_FULL_MOCK_${fileToMockPath} ON)
+        endif ()
+        list(APPEND FSEAM_HEADERS_TO_MOCK ${fileToMockPath})
+    endforeach ()
+    list(REMOVE_DUPLICATES FSEAM_HEADERS_TO_MOCK)
+    set(FSEAM_GENERATOR_RUN_TARGETS "")
+
+    foreach (fileToMockPath ${FSEAM_HEADERS_TO_MOCK})
         get_filename_component(FSEAM_GENERATED_BASENAME ${fileToMockPath} NAME_WE)
+        set(FSEAM_GENERATOR_INPUT ${fileToMockPath})
+        if (FSEAM_SELECTORS_${fileToMockPath} AND NOT FSEAM_FULL_MOCK_${fileToMockPath})
+            # partial mock : the other methods are linked from the real implementation
+            if (NOT ADDFSEAMTESTS_LINK_SEAM AND NOT ADDFSEAMTESTS_PRELOAD)
+                message(FATAL_ERROR "addFSeamTests method selection (${fileToMockPath}:${FSEAM_SELECTORS_${fileToMockPath}}) requires LINK_SEAM or PRELOAD")
+            endif ()
+            string(REPLACE ";" "," FSEAM_GENERATOR_SELECTORS "${FSEAM_SELECTORS_${fileToMockPath}}")
+            set(FSEAM_GENERATOR_INPUT ${fileToMockPath}:${FSEAM_GENERATOR_SELECTORS})
+        endif ()
         # TODO sanitize filename or use glob matching
         list(FILTER FSEAM_TEST_SRC EXCLUDE REGEX .*${FSEAM_GENERATED_BASENAME}.cpp)
+        # the includes of the header are resolved in the include folders of the tested target (dependencies of the mock)
+        set(FSEAM_GENERATOR_OPTIONS "")
+        foreach (includeFolder ${FSEAM_TEST_INCLUDES})
+            list(APPEND FSEAM_GENERATOR_OPTIONS -I${includeFolder})
+        endforeach ()
+        if (FSEAM_GENERATOR_FRONTEND STREQUAL "clang")
+            # the header is parsed with the include folders of the tested target and of the compiler
+            list(APPEND FSEAM_GENERATOR_OPTIONS --frontend=clang)
+            foreach (includeFolder ${CMAKE_CXX_IMPLICIT_INCLUDE_DIRECTORIES})
+                list(APPEND FSEAM_GENERATOR_OPTIONS --clang-arg=-isystem${includeFolder})
+            endforeach ()
+            if (FSEAM_CLANG_PCH)
+                list(APPEND FSEAM_GENERATOR_OPTIONS --pch=${FSEAM_CLANG_PCH})
+            endif ()
+        endif ()
+        foreach (asyncReturnType ${FSEAM_ASYNC_RETURN_TYPES})
+            list(APPEND FSEAM_GENERATOR_OPTIONS --async-return=${asyncReturnType})
+        endforeach ()
+        set(FSEAM_GENERATOR_USAGE "")
+        set(FSEAM_GENERATOR_USAGE_LIST ${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}.fseam.usage)
+        if (FSEAM_PRUNE_SPECIALIZATIONS)
+            # the methods referenced by the test sources (of all the tests mocking the header) are specialized,
+            # the others use the generic implementation
+            foreach (testSource ${ADDFSEAMTESTS_TST_SRC})
+                get_filename_component(testSource ${testSource} ABSOLUTE)
+                list(APPEND FSEAM_GENERATOR_USAGE ${testSource})
+            endforeach ()
+            list(APPEND FSEAM_GENERATOR_OPTIONS --usage-list=${FSEAM_GENERATOR_USAGE_LIST})
+        endif ()
+        if (FSEAM_GENERATOR_DAEMON)
+            list(APPEND FSEAM_GENERATOR_OPTIONS --daemon=${FSEAM_GENERATOR_DAEMON})
+        endif ()
+        set(FSEAM_GENERATOR_DEPFILE_OPTION "")
+        if (FSEAM_GENERATOR_DEPFILE)
+            # the mock is re-generated when a header included by the mocked header changes
+            set(FSEAM_GENERATOR_DEPFILE_PATH ${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}.fseam.d)
+            list(APPEND FSEAM_GENERATOR_OPTIONS --depfile=${FSEAM_GENERATOR_DEPFILE_PATH})
+            set(FSEAM_GENERATOR_DEPFILE_OPTION DEPFILE ${FSEAM_GENERATOR_DEPFILE_PATH})
+        endif ()
         string(REPLACE ";" " " FSEAM_GENERATOR_PRINT "${FSEAM_GENERATOR_COMMMAND}")
-        message(STATUS "add custom command for ${ADDFSEAMTESTS_DESTINATION_TARGET} with fileToMock ${fileToMockPath}\n"
-            "with command : ${FSEAM_GENERATOR_PRINT} ${fileToMockPath} ${FSEAM_GENERATOR_DESTINATION}")
-        add_custom_command(
-            COMMAND
-                ${FSEAM_GENERATOR_COMMMAND}
-                ARGS
+        message(STATUS "add custom command for ${ADDFSEAMTESTS_DESTINATION_TARGET} with fileToMock ${FSEAM_GENERATOR_INPUT}\n"
+            "with command : ${FSEAM_GENERATOR_PRINT} ${FSEAM_GENERATOR_INPUT} ${FSEAM_GENERATOR_DESTINATION}")
+        # a same header can be mocked by several tests of the directory (generated once)
+        get_property(FSEAM_PREVIOUS_INPUT GLOBAL PROPERTY FSEAM_GENERATOR_INPUT_${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME})
+        if (NOT FSEAM_PREVIOUS_INPUT)
+            set_property(GLOBAL PROPERTY FSEAM_GENERATOR_INPUT_${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME} ${FSEAM_GENERATOR_INPUT})
+            set_property(GLOBAL PROPERTY FSEAM_GENERATOR_RUN_${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}
+                    ${ADDFSEAMTESTS_DESTINATION_TARGET}${FSEAM_GENERATED_BASENAME}Run)
+            if (FSEAM_PRUNE_SPECIALIZATIONS)
+                # written at generation time with the usage of all the tests (only re-written if it changed)
+                file(GENERATE OUTPUT ${FSEAM_GENERATOR_USAGE_LIST}
+                        CONTENT "$<JOIN:$<TARGET_PROPERTY:${ADDFSEAMTESTS_DESTINATION_TARGET}${FSEAM_GENERATED_BASENAME}Run,FSEAM_USAGE>,\n>\n")
+            endif ()
+            add_custom_command(
+                COMMAND
+                    ${FSEAM_GENERATOR_COMMMAND}
+                    ARGS
+                        ${FSEAM_GENERATOR_OPTIONS}
+                        ${FSEAM_GENERATOR_INPUT}
+                        ${FSEAM_GENERATOR_DESTINATION}
+                        ${FSEAM_FORCE_GENERATION}
+                OUTPUT
+                    ${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}.fseam.cc
+                DEPENDS
                     ${fileToMockPath}
-                    ${FSEAM_GENERATOR_DESTINATION}
-            OUTPUT
-                ${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}.fseam.cc
-            DEPENDS
-                ${fileToMockPath}
-            USES_TERMINAL
-            COMMENT "Generating FSEAM code for ${fileToMockPath}")
+                    ${FSEAM_GENERATOR_USAGE}
+                    $<$<BOOL:${FSEAM_PRUNE_SPECIALIZATIONS}>:${FSEAM_GENERATOR_USAGE_LIST}>
+                ${FSEAM_GENERATOR_DEPFILE_OPTION}
+                USES_TERMINAL
+                COMMENT "Generating FSEAM code for ${fileToMockPath}")
+            add_custom_target(${ADDFSEAMTESTS_DESTINATION_TARGET}${FSEAM_GENERATED_BASENAME}Run ALL
+                    DEPENDS
+                        ${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}.fseam.cc)
+            # all the generations of the directory update the same FSeamMockData.hpp / FSeamSpecialization.cpp,
+            # they are run one after the other
+            get_property(FSEAM_GENERATOR_LAST_RUN GLOBAL PROPERTY FSEAM_GENERATOR_LAST_RUN_${FSEAM_GENERATOR_DESTINATION})
+            if (FSEAM_GENERATOR_LAST_RUN)
+                add_dependencies(${ADDFSEAMTESTS_DESTINATION_TARGET}${FSEAM_GENERATED_BASENAME}Run ${FSEAM_GENERATOR_LAST_RUN})
+            endif ()
+            set_property(GLOBAL PROPERTY FSEAM_GENERATOR_LAST_RUN_${FSEAM_GENERATOR_DESTINATION}
+                    ${ADDFSEAMTESTS_DESTINATION_TARGET}${FSEAM_GENERATED_BASENAME}Run)
+        elseif (NOT FSEAM_PREVIOUS_INPUT STREQUAL FSEAM_GENERATOR_INPUT)
+            message(FATAL_ERROR "addFSeamTests ${fileToMockPath} is already mocked as ${FSEAM_PREVIOUS_INPUT} by another test "
+                "of the directory, it cannot be mocked as ${FSEAM_GENERATOR_INPUT} by ${ADDFSEAMTESTS_DESTINATION_TARGET}")
+        endif ()
 
-        add_custom_target(${ADDFSEAMTESTS_DESTINATION_TARGET}${FSEAM_GENERATED_BASENAME}Run ALL
-                DEPENDS
-                    ${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}.fseam.cc)
+        # the mock is generated once by the generation target of the first test mocking the header, the test targets
+        # depend on it (and don't re-run the generation, up to date)
+        get_property(FSEAM_GENERATOR_RUN GLOBAL PROPERTY FSEAM_GENERATOR_RUN_${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME})
+        list(APPEND FSEAM_GENERATOR_RUN_TARGETS ${FSEAM_GENERATOR_RUN})
+        if (FSEAM_PRUNE_SPECIALIZATIONS)
+            set_property(TARGET ${FSEAM_GENERATOR_RUN} APPEND PROPERTY FSEAM_USAGE ${FSEAM_GENERATOR_USAGE})
+            if (FSEAM_PREVIOUS_INPUT)
+                add_custom_command(OUTPUT ${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}.fseam.cc APPEND
+                        DEPENDS ${FSEAM_GENERATOR_USAGE})
+            endif ()
+        endif ()
 
         set(FSEAM_TEST_SRC ${FSEAM_TEST_SRC}
                 ${FSEAM_GENERATOR_DESTINATION}/${FSEAM_GENERATED_BASENAME}.fseam.cc)
@@ -64,8 +200,80 @@ function (setup_FSeam_test)
     endforeach()
 #    message(WARNING "AFTER Source compiled ${FSEAM_TEST_SRC}")
     set(FSEAM_TEST_SRC ${FSEAM_TEST_SRC} PARENT_SCOPE)
+    set(FSEAM_GENERATOR_RUN_TARGETS ${FSEAM_GENERATOR_RUN_TARGETS} PARENT_SCOPE)
 endfunction (setup_FSeam_test)
 
+## ============ NOT CLIENT FACING ====================
+## Function used internally in order to link the test target against a copy of the static library TARGET_AS_SOURCE
+## in which every symbol has been weakened (objcopy --weaken): the production code is not recompiled, the strong
+## symbols of the generated mocks take over the weakened real implementation at link time.
+##
+function (setup_FSeam_link_seam)
+    get_target_property(FSEAM_LINK_SEAM_TYPE ${ADDFSEAMTESTS_TARGET_AS_SOURCE} TYPE)
+    if (NOT FSEAM_LINK_SEAM_TYPE STREQUAL "STATIC_LIBRARY")
+        message(FATAL_ERROR "addFSeamTests LINK_SEAM requires TARGET_AS_SOURCE to be a static library "
+            "(${ADDFSEAMTESTS_TARGET_AS_SOURCE} is a ${FSEAM_LINK_SEAM_TYPE})")
+    endif ()
+    if (NOT CMAKE_OBJCOPY)
+        message(FATAL_ERROR "addFSeamTests LINK_SEAM requires objcopy")
+    endif ()
+
+    set(FSEAM_WEAK_LIBRARY
+        ${FSEAM_GENERATOR_DESTINATION}/${CMAKE_STATIC_LIBRARY_PREFIX}${ADDFSEAMTESTS_TARGET_AS_SOURCE}_fseam_weak${CMAKE_STATIC_LIBRARY_SUFFIX})
+    if (NOT TARGET ${ADDFSEAMTESTS_TARGET_AS_SOURCE}FSeamWeak)
+        add_custom_command(
+            COMMAND
+                ${CMAKE_OBJCOPY}
+                ARGS
+                    --weaken
+                    $<TARGET_FILE:${ADDFSEAMTESTS_TARGET_AS_SOURCE}>
+                    ${FSEAM_WEAK_LIBRARY}
+            OUTPUT
+                ${FSEAM_WEAK_LIBRARY}
+            DEPENDS
+                ${ADDFSEAMTESTS_TARGET_AS_SOURCE}
+            COMMENT "Weakening symbols of ${ADDFSEAMTESTS_TARGET_AS_SOURCE} for FSEAM link seam")
+        add_custom_target(${ADDFSEAMTESTS_TARGET_AS_SOURCE}FSeamWeak DEPENDS ${FSEAM_WEAK_LIBRARY})
+    endif ()
+
+    add_dependencies(${ADDFSEAMTESTS_DESTINATION_TARGET} ${ADDFSEAMTESTS_TARGET_AS_SOURCE}FSeamWeak)
+    target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET}
+        ${FSEAM_WEAK_LIBRARY}
+        $<TARGET_PROPERTY:${ADDFSEAMTESTS_TARGET_AS_SOURCE},INTERFACE_LINK_LIBRARIES>)
+endfunction (setup_FSeam_link_seam)
+
+## ============ NOT CLIENT FACING ====================
+## Function used internally in order to build the generated mocks into a shared library (<DESTINATION_TARGET>Mocks)
+## to be interposed at load time (LD_PRELOAD) on top of the shared library TARGET_AS_SOURCE
+##
+function (setup_FSeam_preload)
+    get_target_property(FSEAM_PRELOAD_TYPE ${ADDFSEAMTESTS_TARGET_AS_SOURCE} TYPE)
+    if (NOT FSEAM_PRELOAD_TYPE STREQUAL "SHARED_LIBRARY")
+        message(FATAL_ERROR "addFSeamTests PRELOAD requires TARGET_AS_SOURCE to be a shared library "
+            "(${ADDFSEAMTESTS_TARGET_AS_SOURCE} is a ${FSEAM_PRELOAD_TYPE})")
+    endif ()
+
+    add_library(${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks SHARED ${FSEAM_TEST_SRC})
+    add_dependencies(${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks ${FSEAM_GENERATOR_RUN_TARGETS})
+    set_target_properties(${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks PROPERTIES CXX_STANDARD 17)
+    target_include_directories(${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks
+            PUBLIC
+                ${FSEAM_TEST_INCLUDES}
+                ${FSEAM_GENERATOR_DESTINATION}
+                ${CMAKE_CURRENT_SOURCE_DIR}/../FSeam)
+    # the FSeam-static runtime is not linked in the mocks library, its symbols are resolved from the test executable
+    if (FSEAM_HEADER_ONLY)
+        target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks FSeam)
+    else ()
+        target_include_directories(${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks
+                PUBLIC $<TARGET_PROPERTY:FSeam-static,INTERFACE_INCLUDE_DIRECTORIES>)
+    endif ()
+    if (FSEAM_USE_CATCH2)
+        target_compile_definitions(${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks PRIVATE FSEAM_USE_CATCH2)
+        target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks Catch2::Catch2)
+    endif ()
+endfunction (setup_FSeam_preload)
+
 ## ============ CLIENT FACING ====================
 ## Function to call in order to generate a test executable from the generated FSeam mock and the provided test source
 ##
@@ -73,7 +281,8 @@ endfunction (setup_FSeam_test)
 ## Mandatory
 ## arg DESTINATION_TARGET  : target name of the test executable generated via this method
 ## arg TST_SRC             : files containing the actual test to compile (Catch2, GTest test files for example)
-## arg TO_MOCK             : files to mock for this specific given test
+## arg TO_MOCK             : files to mock for this specific given test, Header.hh:Class::method mocks only the given
+##                           method of the header (requires LINK_SEAM, the other methods come from the real implementation)
 ##
 ## either 
 ## arg TARGET_AS_SOURCE    : target of the library that contains the code to test
@@ -83,12 +292,20 @@ endfunction (setup_FSeam_test)
 ## 
 ## optional 
 ## arg MAIN_FILE           : file containing the main (if any), this file will be removed from the compilation of the test
+## arg LINK_SEAM           : (TARGET_AS_SOURCE static library only) do not recompile the sources of the library for the test,
+##                           link against a copy of the library with weakened symbols overridden by the generated mocks
+## arg PRELOAD             : (TARGET_AS_SOURCE shared library only) build the generated mocks into a shared library
+##                           (<DESTINATION_TARGET>Mocks) interposed with LD_PRELOAD when running the test, the test is
+##                           linked dynamically against the library and doesn't have to be relinked when the mocks change
+## arg ALLOC_SEAM          : link the allocation counting seam (FSeam-alloc) in order to use FSeam::AllocScope in the test
+## arg IO_SEAM             : link the POSIX I/O seam (FSeam-io) in order to script the libc I/O calls (FSeam::IO) in the test
 ##
 function(addFSeamTests)
 
+    set(options LINK_SEAM PRELOAD ALLOC_SEAM IO_SEAM)
     set(oneValueArgs DESTINATION_TARGET TARGET_AS_SOURCE MAIN_FILE)
     set(multiValueArgs TO_MOCK TST_SRC FILES_AS_SOURCE FOLDER_INCLUDES)
-    cmake_parse_arguments(ADDFSEAMTESTS "" "${oneValueArgs}" "${multiValueArgs}"  ${ARGN} )
+    cmake_parse_arguments(ADDFSEAMTESTS "${options}" "${oneValueArgs}" "${multiValueArgs}"  ${ARGN} )
 
     # Check arguments
 
@@ -103,7 +320,19 @@ function(addFSeamTests)
     if (ADDFSEAMTESTS_MAIN_FILE AND NOT ADDFSEAMTESTS_MAIN_FILE STREQUAL "")
         list(FILTER FSEAM_TEST_SRC EXCLUDE REGEX .*${ADDFSEAMTESTS_MAIN_FILE})
     endif ()
+    if (ADDFSEAMTESTS_LINK_SEAM OR ADDFSEAMTESTS_PRELOAD)
+        if (NOT ADDFSEAMTESTS_TARGET_AS_SOURCE OR ADDFSEAMTESTS_TARGET_AS_SOURCE STREQUAL "")
+            message(FATAL_ERROR "addFSeamTests LINK_SEAM / PRELOAD requires TARGET_AS_SOURCE")
+        endif ()
+        # production sources are linked from the library as is
+        set(FSEAM_TEST_SRC "")
+    endif ()
     setup_FSeam_test()
+    if (ADDFSEAMTESTS_PRELOAD)
+        setup_FSeam_preload()
+        # mocks are built in the preloaded library
+        set(FSEAM_TEST_SRC "")
+    endif ()
 
     # Create testing target
     execute_process(COMMAND ${CMAKE_COMMAND} -E touch ${FSEAM_GENERATOR_DESTINATION}/FSeamMockData.hpp ${FSEAM_GENERATOR_DESTINATION}/FSeamSpecialization.cpp)
@@ -111,16 +340,33 @@ function(addFSeamTests)
             ${FSEAM_GENERATOR_DESTINATION}/FSeamMockData.hpp
             ${FSEAM_GENERATOR_DESTINATION}/FSeamSpecialization.cpp)
     set_target_properties(${ADDFSEAMTESTS_DESTINATION_TARGET} PROPERTIES CXX_STANDARD 17)
+    add_dependencies(${ADDFSEAMTESTS_DESTINATION_TARGET} ${FSEAM_GENERATOR_RUN_TARGETS})
     target_include_directories(${ADDFSEAMTESTS_DESTINATION_TARGET}
             PUBLIC
                 ${FSEAM_TEST_INCLUDES}
                 ${FSEAM_GENERATOR_DESTINATION}
                 ${CMAKE_CURRENT_SOURCE_DIR}/../FSeam)
+    if (ADDFSEAMTESTS_LINK_SEAM)
+        setup_FSeam_link_seam()
+    endif ()
+    if (ADDFSEAMTESTS_PRELOAD)
+        # the mocks library uses the FSeam context (and the testing framework) of the test executable
+        set_target_properties(${ADDFSEAMTESTS_DESTINATION_TARGET} PROPERTIES ENABLE_EXPORTS ON)
+        add_dependencies(${ADDFSEAMTESTS_DESTINATION_TARGET} ${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks)
+        target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET} ${ADDFSEAMTESTS_TARGET_AS_SOURCE})
+        set(FSEAM_TEST_PROPERTIES PROPERTIES ENVIRONMENT "LD_PRELOAD=$<TARGET_FILE:${ADDFSEAMTESTS_DESTINATION_TARGET}Mocks>")
+    endif ()
+    if (ADDFSEAMTESTS_ALLOC_SEAM)
+        target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET} FSeam-alloc)
+    endif ()
+    if (ADDFSEAMTESTS_IO_SEAM)
+        target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET} FSeam-io)
+    endif ()
 
     if (FSEAM_USE_CATCH2)
         target_compile_definitions(${ADDFSEAMTESTS_DESTINATION_TARGET} PRIVATE FSEAM_USE_CATCH2)
-        target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET} FSeam Catch2::Catch2)
-        catch_discover_tests(${ADDFSEAMTESTS_DESTINATION_TARGET})
+        target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET} ${FSEAM_RUNTIME_TARGET} Catch2::Catch2)
+        catch_discover_tests(${ADDFSEAMTESTS_DESTINATION_TARGET} ${FSEAM_TEST_PROPERTIES})
     elseif(FSEAM_USE_GTEST)
 #        target_compile_definitions(${ADDFSEAMTESTS_DESTINATION_TARGET} PRIVATE )
 #        target_link_libraries(${ADDFSEAMTESTS_DESTINATION_TARGET} FSeam )
@@ -0,0 +1,141 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <FSeamAlloc.hpp>
+
+namespace {
+
+    // prevent the allocations from being optimized out
+    void *volatile sink = nullptr;
+
+    int sumWithoutAllocation(std::vector<int> &buffer) {
+        buffer.clear();
+        for (int i = 0; i < 16; ++i)
+            buffer.push_back(i);
+        int sum = 0;
+        for (int value : buffer)
+            sum += value;
+        return sum;
+    }
+
+}
+
+TEST_CASE("FSeamAllocTest") {
+
+    SECTION("Allocations and bytes of the scope are counted") {
+        FSeam::AllocScope scope;
+        auto value = std::make_unique<int>(42);
+        auto values = std::make_unique<char[]>(100);
+        sink = value.get();
+        sink = values.get();
+        std::size_t allocations = scope.allocations();
+        std::size_t bytes = scope.bytes();
+        value.reset();
+        std::size_t deallocations = scope.deallocations();
+
+        CHECK(2 == allocations);
+        CHECK(sizeof(int) + 100 == bytes);
+        CHECK(1 == deallocations);
+        CHECK(scope.verifyAllocations(FSeam::AtLeast(2)));
+
+    } // End section : Allocations and bytes of the scope are counted
+
+    SECTION("Zero allocation path") {
+        std::vector<int> buffer;
+        buffer.reserve(16);
+        FSeam::AllocScope scope;
+        int sum = sumWithoutAllocation(buffer);
+
+        CHECK(120 == sum);
+        CHECK(scope.verifyAllocations(FSeam::AtMost(0)));
+        CHECK(scope.verifyBytes(0));
+
+    } // End section : Zero allocation path
+
+    SECTION("The malloc family is counted") {
+        FSeam::AllocScope scope;
+        sink = std::malloc(16);
+        sink = std::realloc(sink, 32);
+        std::free(sink);
+        sink = std::calloc(4, 8);
+        std::free(sink);
+        std::size_t allocations = scope.allocations();
+        std::size_t deallocations = scope.deallocations();
+
+#ifdef __GLIBC__
+        CHECK(3 == allocations);
+        CHECK(3 == deallocations);
+#else
+        CHECK(0 == allocations);
+#endif
+
+    } // End section : The malloc family is counted
+
+    SECTION("Failed verification with sampled stacks") {
+        FSeam::AllocScope scope(2);
+        for (int i = 0; i < 3; ++i) {
+            sink = new int(i);
+            delete static_cast<int *>(sink);
+        }
+
+        CHECK_FALSE(scope.verifyAllocations(FSeam::AtMost(0), false));
+        CHECK(scope.verifyAllocations(3));
+        REQUIRE(2 == scope.samples().size());
+        CHECK(sizeof(int) == scope.samples().front().size);
+#ifdef __GLIBC__
+        CHECK(0 < scope.samples().front().depth);
+#endif
+
+    } // End section : Failed verification with sampled stacks
+
+    SECTION("Nested scopes and untracked allocations") {
+        FSeam::AllocScope outer;
+        sink = new int(1);
+        delete static_cast<int *>(sink);
+        std::size_t innerAllocations;
+        {
+            FSeam::AllocScope inner;
+            sink = new int(2);
+            delete static_cast<int *>(sink);
+            {
+                FSeam::AllocScope::Untracked untracked;
+                sink = new int(3);
+                delete static_cast<int *>(sink);
+            }
+            innerAllocations = inner.allocations();
+        }
+        std::size_t outerAllocations = outer.allocations();
+
+        CHECK(1 == innerAllocations);
+        CHECK(2 == outerAllocations);
+
+    } // End section : Nested scopes and untracked allocations
+
+    SECTION("Allocations of the other threads are not counted") {
+        FSeam::AllocScope scope;
+        std::size_t threadAllocations = 0;
+        {
+            // thread creation allocates in the calling thread
+            FSeam::AllocScope::Untracked untracked;
+            std::thread thread([&threadAllocations]() {
+                FSeam::AllocScope threadScope;
+                sink = new int(4);
+                delete static_cast<int *>(sink);
+                threadAllocations = threadScope.allocations();
+            });
+            thread.join();
+        }
+        std::size_t allocations = scope.allocations();
+
+        CHECK(0 == allocations);
+        CHECK(1 == threadAllocations);
+
+    } // End section : Allocations of the other threads are not counted
+
+}
@@ -0,0 +1,63 @@
+#! /usr/bin/env python
+#
+# Created by FyS on 10/19/26.
+#
+"""
+Test of the asynchronous return types recognized by the FSeam generator: no dupeReturn specialization (copying the
+value) is generated for the methods returning std::future, std::shared_future or a registered awaitable template.
+"""
+
+import contextlib
+import io
+import os
+import re
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Generator"))
+
+import FSeamerFile
+
+HEADER_CONTENT = "#pragma once\n#include <future>\n" \
+                 "namespace source {\nclass Awaiting {\npublic:\n" \
+                 "    std::future<int> future();\n" \
+                 "    std::shared_future<int> sharedFuture();\n" \
+                 "    corolib::Task<int> task();\n" \
+                 "    model::Future<int> userFuture();\n" \
+                 "    int value();\n" \
+                 "};\n}\n"
+
+
+class FSeamAsyncReturnTest(unittest.TestCase):
+
+    def setUp(self):
+        self.folder = tempfile.TemporaryDirectory()
+        self.header = os.path.join(self.folder.name, "Awaiting.hh")
+        with open(self.header, "w") as header:
+            header.write(HEADER_CONTENT)
+
+    def tearDown(self):
+        self.folder.cleanup()
+
+    def specialized(self, argv):
+        """
+        :return: methods for which the dupeReturn is specialized
+        """
+        with contextlib.redirect_stdout(io.StringIO()):
+            FSeamerFile.generateFromCommandLine(argv + [self.header, self.folder.name])
+        with open(os.path.join(self.folder.name, "FSeamMockData.hpp"), "r") as mockData:
+            _content = mockData.read()
+        # one method identifier structure per line
+        return set(re.findall(r"struct (\w+) \{.*DUPE_RETURN_SPECIALIZED = true;", _content))
+
+    def test_standard_futures_only(self):
+        # a template named like an awaitable isn't exempted unless registered
+        self.assertEqual({"task", "userFuture", "value"}, self.specialized([]))
+
+    def test_registered_awaitable(self):
+        self.assertEqual({"userFuture", "value"}, self.specialized(["--async-return=corolib::Task"]))
+
+
+if __name__ == '__main__':
+    unittest.main()
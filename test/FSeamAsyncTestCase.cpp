@@ -0,0 +1,100 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <future>
+#include <AsyncClient.hh>
+#include <FSeamMockData.hpp>
+#include <FSeamAsync.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("FSeamAsyncTest") {
+    source::AsyncClient client {};
+    auto fseamMock = FSeam::get(&client.getStore());
+
+    SECTION("Results are completed by the test, in the order it chooses") {
+        fseamMock->dupeAsyncReturn<FSeam::RemoteStore::fetch>(std::string("value"));
+
+        client.request({1, 2, 3});
+        CHECK(3 == FSeam::AsyncExecutor::pending());
+        CHECK(0 == client.poll());
+        CHECK(3 == client.getInFlight());
+
+        auto ids = FSeam::AsyncExecutor::pendingIds();
+        REQUIRE(3 == ids.size());
+        CHECK(FSeam::AsyncExecutor::run(ids[1]));
+        CHECK_FALSE(FSeam::AsyncExecutor::run(ids[1]));
+        CHECK(1 == client.poll());
+        CHECK(2 == client.getInFlight());
+
+        CHECK(2 == FSeam::AsyncExecutor::runReverse());
+        CHECK(2 == client.poll());
+        CHECK(0 == FSeam::AsyncExecutor::pending());
+        CHECK(std::vector<std::string>(3, "value") == client.getResponses());
+        CHECK(fseamMock->verify(FSeam::RemoteStore::fetch::NAME, 3));
+
+    } // End section : Results are completed by the test, in the order it chooses
+
+    SECTION("Delays are taken on the virtual clock") {
+        fseamMock->dupeAsyncReturn<FSeam::RemoteStore::fetch>(std::string("slow"), 10ms);
+        client.request({1});
+        fseamMock->dupeMethod(FSeam::RemoteStore::fetch::NAME, nullptr);
+        fseamMock->dupeAsyncReturn<FSeam::RemoteStore::fetch>(std::string("fast"), 2ms);
+        client.request({2});
+
+        CHECK(0 == FSeam::AsyncExecutor::advance(1ms));
+        CHECK(1 == FSeam::AsyncExecutor::advance(1ms));
+        CHECK(2ms == FSeam::VirtualClock::elapsed());
+        CHECK(1 == client.poll());
+
+        CHECK(FSeam::AsyncExecutor::runNext());
+        CHECK(10ms == FSeam::VirtualClock::elapsed());
+        CHECK(1 == client.poll());
+        CHECK(std::vector<std::string>{"fast", "slow"} == client.getResponses());
+        CHECK_FALSE(FSeam::AsyncExecutor::runNext());
+
+    } // End section : Delays are taken on the virtual clock
+
+    SECTION("Pipelined requests under high concurrency without threads nor sleeps") {
+        fseamMock->dupeAsyncReturn<FSeam::RemoteStore::fetch>(std::string("value"), 5ms);
+        std::vector<int> keys(10000);
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            keys[i] = static_cast<int>(i);
+
+        client.request(keys);
+        CHECK(10000 == client.getInFlight());
+        CHECK(10000 == FSeam::AsyncExecutor::runShuffled(1337));
+        CHECK(10000 == client.poll());
+        CHECK(0 == FSeam::AsyncExecutor::pending());
+        CHECK(0 == client.getInFlight());
+        CHECK(10000 == client.getResponses().size());
+        // all the results completed at their due time, without waiting
+        CHECK(5ms == FSeam::VirtualClock::elapsed());
+
+    } // End section : Pipelined requests under high concurrency without threads nor sleeps
+
+    SECTION("Pending completions are dropped by reset") {
+        fseamMock->dupeAsyncReturn<FSeam::RemoteStore::fetch>(std::string("value"));
+        client.request({1, 2});
+        std::future<std::string> dropped = client.getStore().fetch(3);
+        FSeam::MockVerifier::reset();
+        CHECK(0 == FSeam::AsyncExecutor::pending());
+        CHECK_FALSE(FSeam::AsyncExecutor::runNext());
+
+        // the promise is released : the waiting future is ready with a broken promise error
+        REQUIRE(std::future_status::ready == dropped.wait_for(0s));
+        try {
+            dropped.get();
+            FAIL("a dropped completion doesn't complete the result");
+        }
+        catch (const std::future_error &error) {
+            CHECK(std::future_errc::broken_promise == error.code());
+        }
+
+    } // End section : Pending completions are dropped by reset
+
+    FSeam::MockVerifier::cleanUp();
+}
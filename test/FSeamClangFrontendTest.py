@@ -0,0 +1,102 @@
+#! /usr/bin/env python
+#
+# Created by FyS on 10/19/26.
+#
+"""
+Test of the libclang frontend of the FSeam generator (--frontend=clang): parsing of the header into the CppHeaderParser
+format, and validity of the precompiled preamble (rebuilt when the clang arguments or the included files change).
+Skipped when the clang python bindings (or libclang) are not available.
+"""
+
+import os
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Generator"))
+
+import FSeamClangFrontend
+
+# no system include : the libclang python wheel doesn't ship the clang builtin headers
+HEADER_CONTENT = "#pragma once\n#include \"Types.hh\"\n" \
+                 "namespace source {\nclass Mocked {\npublic:\n    int first(types::Value value);\n" \
+                 "    types::Value second(const types::Value &value) const;\n    int inlined() { return 1; }\n};\n" \
+                 "int freeFunction(int value);\n}\n"
+OTHER_CONTENT = "#pragma once\n#include \"Types.hh\"\nnamespace source {\nstruct Other {\n    void third(types::Value v);\n};\n}\n"
+TYPES_CONTENT = "#pragma once\nnamespace types {\nstruct Value { int value; };\n}\n"
+
+
+def libclangAvailable():
+    if FSeamClangFrontend.cindex is None:
+        return False
+    try:
+        FSeamClangFrontend._getIndex()
+        return True
+    except Exception:
+        return False
+
+
+def writeFile(path, content):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as file:
+        file.write(content)
+
+
+@unittest.skipUnless(libclangAvailable(), "clang python bindings (libclang) not available")
+class FSeamClangFrontendTest(unittest.TestCase):
+
+    def setUp(self):
+        self.folder = tempfile.TemporaryDirectory()
+        self.include = os.path.join(self.folder.name, "include")
+        self.header = os.path.join(self.folder.name, "src", "Mocked.hh")
+        self.other = os.path.join(self.folder.name, "src", "Other.hh")
+        self.types = os.path.join(self.include, "Types.hh")
+        self.pch = os.path.join(self.folder.name, "fseam.pch")
+        writeFile(self.header, HEADER_CONTENT)
+        writeFile(self.other, OTHER_CONTENT)
+        writeFile(self.types, TYPES_CONTENT)
+
+    def tearDown(self):
+        self.folder.cleanup()
+
+    def parse(self, header, extraArgs=None, pch=None):
+        return FSeamClangFrontend.ClangHeader(header, [self.include], pch, extraArgs)
+
+    def test_header_parsed_into_cpp_header_parser_format(self):
+        _header = self.parse(self.header)
+        _methods = {m["name"]: m for m in _header.classes["Mocked"]["methods"]["public"]}
+        self.assertEqual("source", _header.classes["Mocked"]["namespace"])
+        self.assertEqual("int", _methods["first"]["rtnType"])
+        self.assertEqual("types::Value", _methods["first"]["parameters"][0]["type"])
+        self.assertTrue(_methods["second"]["const"])
+        self.assertTrue(_methods["inlined"]["defined"])
+        self.assertFalse(_methods["first"]["defined"])
+        self.assertEqual(["freeFunction"], [f["name"] for f in _header.functions])
+        self.assertIn(os.path.abspath(self.types), _header.dependencies)
+
+    def test_preamble_reused_by_the_other_headers(self):
+        self.parse(self.header, pch=self.pch)
+        _pchTime = os.stat(self.pch).st_mtime_ns
+        _other = self.parse(self.other, pch=self.pch)
+        self.assertIn("Other", _other.classes)
+        self.assertEqual(_pchTime, os.stat(self.pch).st_mtime_ns)
+
+    def test_preamble_rebuilt_when_the_arguments_change(self):
+        self.parse(self.header, pch=self.pch)
+        _pchTime = os.stat(self.pch).st_mtime_ns
+        _header = self.parse(self.header, ["-DFSEAM_TEST_DEFINE=1"], pch=self.pch)
+        self.assertIn("Mocked", _header.classes)
+        self.assertNotEqual(_pchTime, os.stat(self.pch).st_mtime_ns)
+
+    def test_preamble_rebuilt_when_an_included_file_changes(self):
+        self.parse(self.header, pch=self.pch)
+        writeFile(self.types, "#pragma once\nnamespace types {\nstruct Value { int value; long other; };\n}\n")
+        _stat = os.stat(self.pch)
+        os.utime(self.types, ns=(_stat.st_atime_ns, _stat.st_mtime_ns + 1000000000))
+        _header = self.parse(self.header, pch=self.pch)
+        self.assertIn("Mocked", _header.classes)
+        self.assertGreater(os.stat(self.pch).st_mtime_ns, _stat.st_mtime_ns)
+
+
+if __name__ == '__main__':
+    unittest.main()
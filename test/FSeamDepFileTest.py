@@ -0,0 +1,75 @@
+#! /usr/bin/env python
+#
+# Created by FyS on 10/19/26.
+#
+"""
+Test of the dependency file written by the FSeam generator (DEPFILE of the generation): the headers included by the
+mocked header, resolved in its folder and in the include folders, re-generate the mock when they change.
+"""
+
+import contextlib
+import io
+import os
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Generator"))
+
+import FSeamerFile
+
+HEADER_CONTENT = "#pragma once\n#include <string>\n#include \"types/Types.hh\"\n" \
+                 "namespace source {\nclass Mocked {\npublic:\n    int first(types::Value value);\n};\n}\n"
+TYPES_CONTENT = "#pragma once\n#include \"Inner.hh\"\nnamespace types {\nstruct Value { Inner inner; };\n}\n"
+INNER_CONTENT = "#pragma once\nnamespace types {\nstruct Inner { int value; };\n}\n"
+
+
+def writeFile(path, content):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as file:
+        file.write(content)
+
+
+class FSeamDepFileTest(unittest.TestCase):
+
+    def setUp(self):
+        self.folder = tempfile.TemporaryDirectory()
+        self.include = os.path.join(self.folder.name, "include")
+        self.header = os.path.join(self.folder.name, "src", "Mocked.hh")
+        self.types = os.path.join(self.include, "types", "Types.hh")
+        self.inner = os.path.join(self.include, "types", "Inner.hh")
+        self.depFile = os.path.join(self.folder.name, "Mocked.fseam.d")
+        self.generated = os.path.join(self.folder.name, "Mocked.fseam.cc")
+        writeFile(self.header, HEADER_CONTENT)
+        writeFile(self.types, TYPES_CONTENT)
+        writeFile(self.inner, INNER_CONTENT)
+
+    def tearDown(self):
+        self.folder.cleanup()
+
+    def generate(self, forceGeneration):
+        with contextlib.redirect_stdout(io.StringIO()) as output:
+            FSeamerFile.generateFSeamFile(self.header, self.folder.name, forceGeneration,
+                                          includeFolders=[self.include], depFile=self.depFile)
+        return output.getvalue()
+
+    def test_depfile_lists_resolved_includes(self):
+        self.generate(True)
+        with open(self.depFile, "r") as depFile:
+            _content = depFile.read()
+        self.assertTrue(_content.startswith(self.generated + ":"))
+        for dependency in [self.header, self.types, self.inner]:
+            self.assertIn(dependency, _content)
+        # system headers not found in the include folders are not dependencies
+        self.assertNotIn("string", _content)
+
+    def test_included_header_change_regenerates(self):
+        self.generate(True)
+        self.assertIn("already generated", self.generate(False))
+        _stat = os.stat(self.generated)
+        os.utime(self.inner, ns=(_stat.st_atime_ns, _stat.st_mtime_ns + 1000000000))
+        self.assertNotIn("already generated", self.generate(False))
+
+
+if __name__ == '__main__':
+    unittest.main()
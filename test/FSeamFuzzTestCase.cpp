@@ -0,0 +1,102 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <TestingClass.hh>
+#include <FSeamMockData.hpp>
+#include <FSeamLatency.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    std::vector<std::uint8_t> toInput(const std::vector<int> &values) {
+        std::vector<std::uint8_t> input(values.size() * sizeof(int));
+        std::memcpy(input.data(), values.data(), input.size());
+        return input;
+    }
+
+}
+
+TEST_CASE("FSeamFuzzTest") {
+    source::TestingClass testingClass {};
+    auto &dependency = testingClass.getDepGettable();
+    auto fseamMock = FSeam::get(&dependency);
+
+    SECTION("Returned values are taken from the fuzzer input") {
+        fseamMock->dupeFromFuzzInput<FSeam::DependencyGettable::checkSimpleReturnValue>();
+        auto input = toInput({42, -7});
+
+        FSeam::FuzzInput::set(input.data(), input.size());
+        CHECK(42 == dependency.checkSimpleReturnValue());
+        CHECK(-7 == dependency.checkSimpleReturnValue());
+        // exhausted input
+        CHECK(0 == dependency.checkSimpleReturnValue());
+
+        // the same input replays the same values
+        FSeam::FuzzInput::set(input.data(), input.size());
+        CHECK(42 == dependency.checkSimpleReturnValue());
+
+    } // End section : Returned values are taken from the fuzzer input
+
+    SECTION("Strings and booleans from the fuzzer input") {
+        const std::uint8_t input[] = {3, 'a', 'b', 'c', 0x11, 200, 'x'};
+
+        FSeam::FuzzInput::set(input, sizeof(input));
+        CHECK("abc" == FSeam::FuzzInput::consume<std::string>());
+        CHECK(FSeam::FuzzInput::consume<bool>());
+        // length truncated to the remaining input
+        CHECK("x" == FSeam::FuzzInput::consume<std::string>());
+        CHECK(0u == FSeam::FuzzInput::remaining());
+
+    } // End section : Strings and booleans from the fuzzer input
+
+    SECTION("Reset clears the calls and keeps dupes and expectations") {
+        fseamMock->dupeFromFuzzInput<FSeam::DependencyGettable::checkSimpleReturnValue>();
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(FSeam::Eq(1), FSeam::Any(), FSeam::VerifyCompare{1});
+        fseamMock->deferExpectations();
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(FSeam::Any(), FSeam::Eq(std::string("b")), FSeam::VerifyCompare{2});
+        fseamMock->expectArgTable<FSeam::DependencyGettable::checkSimpleInputVariable>({
+            {{FSeam::Eq(2), FSeam::Eq(std::string("b"))}, FSeam::VerifyCompare{1}}
+        });
+
+        for (int iteration = 0; iteration < 1000; ++iteration) {
+            auto input = toInput({iteration});
+            FSeam::FuzzInput::set(input.data(), input.size());
+
+            REQUIRE(iteration == dependency.checkSimpleReturnValue());
+            dependency.checkSimpleInputVariable(1, "a");
+            dependency.checkSimpleInputVariable(2, "b");
+            dependency.checkSimpleInputVariable(3, "b");
+            REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleReturnValue::NAME, 1));
+            REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 3));
+            FSeam::MockVerifier::reset();
+        }
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkSimpleReturnValue::NAME, FSeam::NeverCalled{}));
+        // the expectations are kept, they are not fulfilled anymore
+        CHECK_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, FSeam::NeverCalled{}, false));
+
+    } // End section : Reset clears the calls and keeps dupes and expectations
+
+    SECTION("Reset rewinds the virtual clock and refills the rate limits") {
+        FSeam::VirtualClock::setOrigin(1h);
+        fseamMock->dupeRateLimit<FSeam::DependencyGettable::checkCalled>(FSeam::Latency::TokenBucket(1, 10s));
+
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            dependency.checkCalled();
+            CHECK(0s == FSeam::VirtualClock::elapsed());
+            dependency.checkCalled();
+            CHECK(10s == FSeam::VirtualClock::elapsed());
+            FSeam::MockVerifier::reset();
+        }
+        CHECK(1h == FSeam::VirtualClock::now().time_since_epoch());
+
+    } // End section : Reset rewinds the virtual clock and refills the rate limits
+
+    FSeam::MockVerifier::cleanUp();
+}
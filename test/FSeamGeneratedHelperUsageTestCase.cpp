@@ -4,11 +4,40 @@
 
 #include <catch2/catch.hpp>
 #include <any>
+#include <memory>
+#include <string>
+#include <vector>
 #include <TestingClass.hh>
 #include <FSeamMockData.hpp>
 
 using namespace FSeam;
 
+namespace {
+
+    /**
+     * @brief Method identifier of a method returning a move-only type (written as the generator does)
+     */
+    struct MoveOnlyData {
+        std::unique_ptr<int> create_ReturnValue;
+    };
+
+    struct create {
+        static constexpr std::string_view NAME = "create";
+        static constexpr std::string_view CLASS_NAME = "MoveOnlyFactory";
+        static auto &returnValue(void *d) { return static_cast<MoveOnlyData *>(d)->create_ReturnValue; }
+    };
+
+    std::vector<std::string> loggedErrors;
+
+    std::unique_ptr<int> callCreate(FSeam::MockClassVerifier &mock) {
+        MoveOnlyData data;
+        mock.invokeDupedMethod(create::NAME, &data);
+        mock.methodCall(create::NAME, &data);
+        return std::move(data.create_ReturnValue);
+    }
+
+}
+
 TEST_CASE("Test HelperMethods Simple UseCase") {
     source::TestingClass testClass{};
     auto fseamMock = FSeam::get(&testClass.getDepGettable());
@@ -37,6 +66,60 @@ TEST_CASE("Test HelperMethods Simple UseCase") {
 
         } // End section : Custom struct/class
 
+        SECTION("Sequence of values") {
+            fseamMock->dupeReturnSequence<FSeam::DependencyGettable::checkSimpleReturnValue>({1, 2, -1});
+            REQUIRE(1 == testClass.getDepGettable().checkSimpleReturnValue());
+            REQUIRE(2 == testClass.getDepGettable().checkSimpleReturnValue());
+            REQUIRE(-1 == testClass.getDepGettable().checkSimpleReturnValue());
+            REQUIRE(-1 == testClass.getDepGettable().checkSimpleReturnValue());
+            REQUIRE(-1 == testClass.getDepGettable().checkSimpleReturnValue());
+            REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleReturnValue::NAME, 5));
+
+        } // End section : Sequence of values
+
+        SECTION("Sequence of custom struct/class") {
+            fseamMock->dupeReturnSequence<FSeam::DependencyGettable::checkCustomStructReturnValue>(
+                    {source::StructTest{1, 11, "first"}, source::StructTest{2, 22, "last"}});
+            REQUIRE(std::string("first") == testClass.getDepGettable().checkCustomStructReturnValue().testStr);
+            REQUIRE(std::string("last") == testClass.getDepGettable().checkCustomStructReturnValue().testStr);
+            REQUIRE(std::string("last") == testClass.getDepGettable().checkCustomStructReturnValue().testStr);
+
+        } // End section : Sequence of custom struct/class
+
+        SECTION("Sequence of move-only values, the last one is returned once") {
+            FSeam::MockClassVerifier mock("MoveOnlyFactory");
+            std::vector<std::unique_ptr<int>> values;
+            values.emplace_back(std::make_unique<int>(1));
+            values.emplace_back(std::make_unique<int>(2));
+            mock.dupeReturnSequence<create>(std::move(values));
+
+            Logging::Logger::custom([](Logging::Level level, const std::string &msg) {
+                if (level == Logging::Level::ERROR)
+                    loggedErrors.emplace_back(msg);
+            });
+            loggedErrors.clear();
+            auto first = callCreate(mock);
+            auto last = callCreate(mock);
+            auto exhausted = callCreate(mock);
+            Logging::Logger::customEnabled = false;
+
+            REQUIRE((first && 1 == *first));
+            REQUIRE((last && 2 == *last));
+            CHECK_FALSE(exhausted);
+            REQUIRE(1 == loggedErrors.size());
+            CHECK(std::string::npos != loggedErrors.front().find("MoveOnlyFactory::create"));
+
+        } // End section : Sequence of move-only values, the last one is returned once
+
+        SECTION("Cycle of values") {
+            fseamMock->dupeReturnCycle<FSeam::DependencyGettable::checkSimpleReturnValue>({1, 2});
+            REQUIRE(1 == testClass.getDepGettable().checkSimpleReturnValue());
+            REQUIRE(2 == testClass.getDepGettable().checkSimpleReturnValue());
+            REQUIRE(1 == testClass.getDepGettable().checkSimpleReturnValue());
+            REQUIRE(2 == testClass.getDepGettable().checkSimpleReturnValue());
+
+        } // End section : Cycle of values
+
     } // End section : Test DupeReturn
 
     SECTION("Clear expectations") {
@@ -205,9 +288,18 @@ TEST_CASE("Test HelperMethods Simple UseCase") {
             REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 4));
             testClass.getDepGettable().checkSimpleInputVariable(29, "dede"); // AtMost(1) not respected
             REQUIRE_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 5, false));
-            
+
         } // End section : Multiple expectation
 
+        SECTION("Generic expectArg (no generated specialization)") {
+            // method without argument: no expectArg specialization is generated for it
+            fseamMock->expectArg<FSeam::DependencyGettable::checkCalled>(VerifyCompare{2});
+            testClass.getDepGettable().checkCalled();
+            REQUIRE_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, false));
+            testClass.getDepGettable().checkCalled();
+            REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME));
+        } // End section : Generic expectArg (no generated specialization)
+
     } // End section : Test ExpectArg
 
     FSeam::MockVerifier::cleanUp();
@@ -326,9 +418,174 @@ TEST_CASE("Test HelperMethods Specific UseCase") {
     } // End section : Non movable Object manipulation
 
     SECTION("Non copiable Object manipulation") {
+        fseamMock->expectArg<FSeam::DependencyGettable::checkMoveOnlyInputVariable>(
+                FSeam::CustomComparator<const std::unique_ptr<source::StructTest> &>([](const auto &param) {
+                    return param && param->testInt == 1 && param->testStr == "111";
+                }), FSeam::VerifyCompare{1});
+        fseamMock->expectArg<FSeam::DependencyGettable::checkMoveOnlyInputVariable>(FSeam::Any(), FSeam::VerifyCompare{2});
+        testClass.getDepGettable().checkMoveOnlyInputVariable(std::make_unique<source::StructTest>(source::StructTest{1, 11, "111"}));
+        testClass.getDepGettable().checkMoveOnlyInputVariable(nullptr);
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkMoveOnlyInputVariable::NAME, 2));
 
     } // End section : Non copiable Object manipulation
 
+    SECTION("Large trivially copyable Object manipulation") {
+        static_assert(!FSeam::CaptureTraits<source::LargeMessageTest>::copied);
+        int lastId = 0;
+        fseamMock->dupeMethod(FSeam::DependencyGettable::checkLargeMessageInputVariable::NAME, [&lastId](void *data) {
+            lastId = static_cast<FSeam::DependencyGettableData *>(data)->checkLargeMessageInputVariable_message_ParamValue->get().id;
+        });
+        fseamMock->expectArg<FSeam::DependencyGettable::checkLargeMessageInputVariable>(
+                FSeam::CustomComparator<const source::LargeMessageTest &>([](const auto &param) {
+                    return param.id == 42 && param.payload[1023] == 'F';
+                }), FSeam::VerifyCompare{1});
+        source::LargeMessageTest message {};
+        for (int i = 0; i < 100; ++i) {
+            message.id = i;
+            message.payload[1023] = 'F';
+            testClass.getDepGettable().checkLargeMessageInputVariable(message);
+        }
+        REQUIRE(99 == lastId);
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkLargeMessageInputVariable::NAME, 100));
+
+    } // End section : Large trivially copyable Object manipulation
+
+    SECTION("An argument not captured doesn't match, in the immediate and the deferred modes") {
+        for (bool deferred : {false, true}) {
+            fseamMock->deferExpectations(deferred);
+            fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(Any(), Eq(std::string("FyS")), NeverCalled{});
+            // call data structure without captured arguments (filled by a custom caller for instance)
+            FSeam::DependencyGettableData data {};
+            fseamMock->methodCall(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, &data);
+            REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 1));
+            fseamMock->clearExpectations();
+            fseamMock->reset();
+        }
+
+    } // End section : An argument not captured doesn't match, in the immediate and the deferred modes
+
     FSeam::MockVerifier::cleanUp();
 } // End TestCase : Test HelperMethods Specific UseCase
 
+
+TEST_CASE("Test HelperMethods Deferred expectations") {
+    source::TestingClass testClass{};
+    auto fseamMock = FSeam::get(&testClass.getDepGettable());
+    fseamMock->deferExpectations();
+
+    SECTION("Eq / NotEq / Any Comparator") {
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(Eq(29), Any(), VerifyCompare{2});
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(NotEq(29), Eq(std::string("FyS")), VerifyCompare{2});
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(Eq(29), Eq(std::string("dede")), AtMost{1});
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(Eq(1337), Any(), NeverCalled{});
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dede");
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dode");
+        testClass.getDepGettable().checkSimpleInputVariable(33, "FyS");
+        testClass.getDepGettable().checkSimpleInputVariable(41, "FyS");
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 4));
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dede"); // AtMost(1) and VerifyCompare{2} not respected
+        REQUIRE_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 5, false));
+
+    } // End section : Eq / NotEq / Any Comparator
+
+    SECTION("Only calls made after the registration are checked") {
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dede");
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(Eq(29), Any(), VerifyCompare{1});
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dede");
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(Eq(29), Any(), NeverCalled{});
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 2));
+
+    } // End section : Only calls made after the registration are checked
+
+    SECTION("Custom Comparator") {
+        fseamMock->expectArg<FSeam::DependencyGettable::checkCustomStructInputVariable>(
+                CustomComparator<source::StructTest>([](auto test){ return test.testInt == 1; }), VerifyCompare{2});
+        testClass.getDepGettable().checkCustomStructInputVariable(source::StructTest{1, 11, "111"});
+        testClass.getDepGettable().checkCustomStructInputVariable(source::StructTest{2, 22, "222"});
+        testClass.getDepGettable().checkCustomStructInputVariable(source::StructTest{1, 33, "333"});
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkCustomStructInputVariable::NAME, 3));
+
+    } // End section : Custom Comparator
+
+    SECTION("Referenced arguments are copied") {
+        fseamMock->expectArg<FSeam::DependencyGettable::checkCustomStructInputVariableRef>(
+                FSeam::CustomComparator<const source::StructTest &>([](auto param) { return param.testStr == "111"; }));
+        {
+            source::StructTest structTest {1, 11, "111"};
+            testClass.getDepGettable().checkCustomStructInputVariableRef(structTest);
+        }
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkCustomStructInputVariableRef::NAME));
+
+    } // End section : Referenced arguments are copied
+
+    SECTION("Clear expectations") {
+        fseamMock->expectArg<FSeam::DependencyGettable::checkSimpleInputVariable>(Any(), Any(), NeverCalled{});
+        testClass.getDepGettable().checkSimpleInputVariable(41, "FyS");
+        REQUIRE_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, false));
+        fseamMock->clearExpectations();
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME));
+
+    } // End section : Clear expectations
+
+    FSeam::MockVerifier::cleanUp();
+} // End TestCase : Test HelperMethods Deferred expectations
+
+TEST_CASE("Test HelperMethods expectArgTable") {
+    source::TestingClass testClass{};
+    auto fseamMock = FSeam::get(&testClass.getDepGettable());
+
+    SECTION("Indexed rows") {
+        std::vector<ArgRow> rows;
+        for (int i = 0; i < 500; ++i)
+            rows.emplace_back(std::vector<ArgComp>{Eq(i), Eq(std::to_string(i))}, VerifyCompare{static_cast<uint>(i % 3)});
+        fseamMock->expectArgTable<FSeam::DependencyGettable::checkSimpleInputVariable>(rows);
+        for (int i = 0; i < 500; ++i)
+            for (int call = 0; call < i % 3; ++call)
+                testClass.getDepGettable().checkSimpleInputVariable(i, std::to_string(i));
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME));
+        testClass.getDepGettable().checkSimpleInputVariable(3, "3");
+        REQUIRE_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, false));
+        testClass.getDepGettable().checkSimpleInputVariable(3, "4"); // match no row
+        fseamMock->clearExpectations();
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME));
+
+    } // End section : Indexed rows
+
+    SECTION("Duplicated rows") {
+        fseamMock->expectArgTable<FSeam::DependencyGettable::checkSimpleInputVariable>({
+            {{Eq(29), Eq(std::string("dede"))}, VerifyCompare{2}},
+            {{Eq(29), Eq(std::string("dede"))}, AtMost{2}}
+        });
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dede");
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dede");
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 2));
+
+    } // End section : Duplicated rows
+
+    SECTION("Mixed indexed and linear rows") {
+        fseamMock->expectArgTable<FSeam::DependencyGettable::checkSimpleInputVariable>({
+            {{Eq(29), Eq(std::string("dede"))}, VerifyCompare{1}},
+            {{Eq(29), Any()}, VerifyCompare{2}},
+            {{NotEq(29), Eq(std::string("FyS"))}},
+            {{Eq(1337), Eq(std::string("FSeam"))}, NeverCalled{}}
+        });
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dede");
+        testClass.getDepGettable().checkSimpleInputVariable(29, "dode");
+        testClass.getDepGettable().checkSimpleInputVariable(33, "FyS");
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 3));
+        testClass.getDepGettable().checkSimpleInputVariable(1337, "FSeam");
+        REQUIRE_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 4, false));
+
+    } // End section : Mixed indexed and linear rows
+
+    SECTION("Not hashable arguments") {
+        fseamMock->expectArgTable<FSeam::DependencyGettable::checkCustomStructInputVariable>({
+            {{CustomComparator<source::StructTest>([](auto test){ return test.testInt == 1; })}, VerifyCompare{1}}
+        });
+        testClass.getDepGettable().checkCustomStructInputVariable(source::StructTest{1, 11, "111"});
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkCustomStructInputVariable::NAME, 1));
+
+    } // End section : Not hashable arguments
+
+    FSeam::MockVerifier::cleanUp();
+} // End TestCase : Test HelperMethods expectArgTable
@@ -0,0 +1,87 @@
+#! /usr/bin/env python
+#
+# Created by FyS on 10/19/26.
+#
+"""
+Timing test of the FSeam generator: the code emission (mock file, FSeamMockData.hpp and FSeamSpecialization.cpp, also
+re-generated on top of their previous content) has to scale linearly with the size of the header.
+The parsing of the header (CppHeaderParser) is not timed, the header is parsed once and given as frontend.
+"""
+
+import contextlib
+import copy
+import gc
+import io
+import os
+import sys
+import tempfile
+import time
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Generator"))
+
+import CppHeaderParser
+import FSeamerFile
+
+METHODS_PER_CLASS = 90
+# linear emission gives a ratio of ~4 between the two header sizes, quadratic emission a ratio of ~16
+MAX_RATIO = 8
+
+
+def writeSyntheticHeader(path, methodCount):
+    """
+    Header of methodCount methods: classes of METHODS_PER_CLASS methods, and methodCount / 10 free functions
+    """
+    _classCount = (methodCount - methodCount // 10) // METHODS_PER_CLASS
+    _lines = ["#pragma once\n", "#include <string>\n", "namespace source {\n"]
+    for c in range(_classCount):
+        _lines.append("class Synthetic" + str(c) + " {\npublic:\n")
+        for m in range(METHODS_PER_CLASS):
+            _lines.append("    int method" + str(m) + "(int value, const std::string &name);\n")
+        _lines.append("};\n")
+    for f in range(methodCount // 10):
+        _lines.append("int freeFunction" + str(f) + "(int value);\n")
+    _lines.append("}\n")
+    with open(path, "w") as header:
+        header.write("".join(_lines))
+
+
+def timeEmission(folder, methodCount):
+    _headerPath = os.path.join(folder, "Synthetic" + str(methodCount) + ".hh")
+    writeSyntheticHeader(_headerPath, methodCount)
+    with contextlib.redirect_stdout(io.StringIO()):
+        _parsed = CppHeaderParser.CppHeader(_headerPath)
+    _elapsed = 0.0
+    _dataContent = ""
+    _specContent = ""
+    # second pass re-generates the content on top of the first one (clear of the previous data)
+    for _ in range(2):
+        _fSeamerFile = FSeamerFile.FSeamerFile(_headerPath, frontend=lambda path: copy.deepcopy(_parsed))
+        # the garbage collector passes depend on the number of live objects (the parsed header), not on the emission
+        gc.collect()
+        gc.disable()
+        _begin = time.perf_counter()
+        _fSeamerFile.seamParse()
+        _dataContent = _fSeamerFile.generateDataStructureContent(_dataContent.replace(FSeamerFile.LOCKING_FOOTER, ""))
+        _specContent = _fSeamerFile.getSpecializationContent(_specContent)
+        _elapsed += time.perf_counter() - _begin
+        gc.enable()
+    return _elapsed, _dataContent, _specContent
+
+
+class FSeamGeneratorScalingTest(unittest.TestCase):
+
+    def test_emission_is_linear(self):
+        with tempfile.TemporaryDirectory() as folder:
+            _smallTime, _, _ = timeEmission(folder, 2500)
+            _largeTime, _dataContent, _specContent = timeEmission(folder, 10000)
+        # re-generation replaced the previous data instead of appending it
+        self.assertEqual(1, _dataContent.count("struct Synthetic0Data {"))
+        self.assertEqual(1, _specContent.count("// Duping/Expectations specializations for Synthetic0\n"))
+        self.assertEqual(1, _specContent.count("// Generated duping for method FreeFunction::freeFunction0 begin\n"))
+        print("emission time 2500 methods: %.3fs, 10000 methods: %.3fs" % (_smallTime, _largeTime))
+        self.assertLess(_largeTime, _smallTime * MAX_RATIO)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,183 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <FSeamIO.hpp>
+#include <FSeamLatency.hpp>
+#include <FSeamSchedule.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    std::string readAll(int fd, std::size_t size) {
+        std::string content(size, '\0');
+        ssize_t received = read(fd, content.data(), size);
+        content.resize(received < 0 ? 0 : static_cast<std::size_t>(received));
+        return content;
+    }
+
+}
+
+TEST_CASE("FSeamIOTest") {
+    int pipeFds[2];
+    REQUIRE(0 == pipe(pipeFds));
+    int readFd = pipeFds[0];
+    int writeFd = pipeFds[1];
+
+    SECTION("Partial reads and EAGAIN") {
+        REQUIRE(11 == write(writeFd, "hello world", 11));
+        FSeam::IO::dupeSequence("read", readFd, {FSeam::IO::Partial(3), FSeam::IO::Error(EAGAIN), FSeam::IO::PassThrough()});
+
+        CHECK("hel" == readAll(readFd, 64));
+        char buffer[64];
+        errno = 0;
+        CHECK(-1 == read(readFd, buffer, sizeof(buffer)));
+        CHECK(EAGAIN == errno);
+        CHECK("lo world" == readAll(readFd, 64));
+
+        CHECK(FSeam::getFreeFunc()->verify("read", 3));
+        // not watched
+        CHECK(FSeam::getFreeFunc()->verify("write", FSeam::NeverCalled{}));
+
+    } // End section : Partial reads and EAGAIN
+
+    SECTION("Scripted data without reading the file descriptor") {
+        FSeam::IO::dupeSequence("read", readFd, {FSeam::IO::Data("abc"), FSeam::IO::Data("")});
+
+        CHECK("ab" == readAll(readFd, 2));
+        CHECK(readAll(readFd, 64).empty());
+
+    } // End section : Scripted data without reading the file descriptor
+
+    SECTION("Short writes") {
+        FSeam::IO::dupeSequence("write", writeFd, {FSeam::IO::Partial(2)});
+        FSeam::IO::dupeSequence("writev", writeFd, {FSeam::IO::Partial(4)});
+
+        CHECK(2 == write(writeFd, "hello", 5));
+        char first[] = "abc";
+        char second[] = "def";
+        struct iovec iov[] = {{first, 3}, {second, 3}};
+        CHECK(4 == writev(writeFd, iov, 2));
+        CHECK("heabcd" == readAll(readFd, 64));
+
+    } // End section : Short writes
+
+    SECTION("Latency on the virtual clock") {
+        FSeam::IO::dupeLatency("write", writeFd, FSeam::Latency::Fixed(5ms));
+
+        CHECK(1 == write(writeFd, "x", 1));
+        CHECK(1 == write(writeFd, "y", 1));
+        CHECK(10ms == FSeam::VirtualClock::elapsed());
+
+    } // End section : Latency on the virtual clock
+
+    SECTION("open, fsync and mmap errors") {
+        char path[] = "/tmp/FSeamIOTestXXXXXX";
+        int fd = mkstemp(path);
+        REQUIRE(0 <= fd);
+        REQUIRE(4 == write(fd, "data", 4));
+        FSeam::IO::dupeSequence("open", std::string(path), {FSeam::IO::Error(EMFILE)});
+        FSeam::IO::dupeSequence("fsync", fd, {FSeam::IO::Error(EIO)});
+        FSeam::IO::dupeSequence("mmap", fd, {FSeam::IO::Error(ENOMEM)});
+
+        errno = 0;
+        CHECK(-1 == open(path, O_RDONLY));
+        CHECK(EMFILE == errno);
+        int reopened = open(path, O_RDONLY);
+        CHECK(0 <= reopened);
+        close(reopened);
+
+        CHECK(-1 == fsync(fd));
+        CHECK(EIO == errno);
+        CHECK(0 == fsync(fd));
+
+        CHECK(MAP_FAILED == mmap(nullptr, 4, PROT_READ, MAP_PRIVATE, fd, 0));
+        CHECK(ENOMEM == errno);
+        void *mapped = mmap(nullptr, 4, PROT_READ, MAP_PRIVATE, fd, 0);
+        REQUIRE(MAP_FAILED != mapped);
+        CHECK(std::string("data") == std::string(static_cast<const char *>(mapped), 4));
+        munmap(mapped, 4);
+
+        CHECK(FSeam::getFreeFunc()->verify("open", 2));
+        close(fd);
+        unlink(path);
+
+    } // End section : open, fsync and mmap errors
+
+    SECTION("epoll_wait interrupted and capped") {
+        int epollFd = epoll_create1(0);
+        REQUIRE(0 <= epollFd);
+        int otherPipe[2];
+        REQUIRE(0 == pipe(otherPipe));
+        struct epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = readFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, readFd, &event);
+        event.data.fd = otherPipe[0];
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, otherPipe[0], &event);
+        REQUIRE(1 == write(writeFd, "a", 1));
+        REQUIRE(1 == write(otherPipe[1], "b", 1));
+        FSeam::IO::dupeSequence("epoll_wait", epollFd, {FSeam::IO::Error(EINTR), FSeam::IO::Partial(1)});
+
+        struct epoll_event events[4];
+        CHECK(-1 == epoll_wait(epollFd, events, 4, 0));
+        CHECK(EINTR == errno);
+        CHECK(1 == epoll_wait(epollFd, events, 4, 0));
+        CHECK(2 == epoll_wait(epollFd, events, 4, 0));
+
+        close(otherPipe[0]);
+        close(otherPipe[1]);
+        close(epollFd);
+
+    } // End section : epoll_wait interrupted and capped
+
+    SECTION("A closed file descriptor stops being watched") {
+        int other[2];
+        REQUIRE(0 == pipe(other));
+        FSeam::IO::watch(other[1]);
+        REQUIRE(1 == write(other[1], "a", 1));
+        close(other[0]);
+        close(other[1]);
+
+        // the numbers of the closed file descriptors are reused
+        REQUIRE(0 == pipe(other));
+        REQUIRE(1 == write(other[1], "b", 1));
+        CHECK(FSeam::getFreeFunc()->verify("write", 1));
+        close(other[0]);
+        close(other[1]);
+
+    } // End section : A closed file descriptor stops being watched
+
+    SECTION("Controlled threads suspended on a watched call don't block each other") {
+        FSeam::IO::watch(writeFd);
+        FSeam::Schedule::Options options;
+        options.strategy = FSeam::Schedule::Strategy::Exhaustive;
+        options.preemptions = 1;
+
+        auto result = FSeam::Schedule::explore(options, [writeFd](FSeam::Schedule::Run &run) {
+            for (int i = 0; i < 2; ++i)
+                run.spawn([writeFd]() { write(writeFd, "a", 1); });
+            run.join();
+            return true;
+        });
+        CHECK_FALSE(result.failed);
+        CHECK(FSeam::getFreeFunc()->verify("write", 2 * result.runs));
+
+    } // End section : Controlled threads suspended on a watched call don't block each other
+
+    FSeam::IO::unwatchAll();
+    FSeam::MockVerifier::cleanUp();
+    close(readFd);
+    close(writeFd);
+}
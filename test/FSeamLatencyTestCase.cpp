@@ -0,0 +1,95 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <TestingClass.hh>
+#include <FSeamMockData.hpp>
+#include <FSeamLatency.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("FSeamLatencyTest") {
+    source::TestingClass testingClass {};
+    auto fseamMock = FSeam::get(&testingClass.getDepGettable());
+
+    SECTION("Fixed latency moves the virtual clock without sleeping") {
+        fseamMock->dupeLatency<FSeam::DependencyGettable::checkCalled>(FSeam::Latency::Fixed(10s));
+
+        testingClass.getDepGettable().checkCalled();
+        testingClass.getDepGettable().checkCalled();
+        CHECK(20s == FSeam::VirtualClock::elapsed());
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, 2));
+
+    } // End section : Fixed latency moves the virtual clock without sleeping
+
+    SECTION("Latency is composed with return value dupe") {
+        fseamMock->dupeReturn<FSeam::DependencyGettable::checkSimpleReturnValue>(42);
+        fseamMock->dupeLatency<FSeam::DependencyGettable::checkSimpleReturnValue>(FSeam::Latency::Fixed(5ms));
+
+        CHECK(42 == testingClass.getDepGettable().checkSimpleReturnValue());
+        CHECK(5ms == FSeam::VirtualClock::elapsed());
+
+    } // End section : Latency is composed with return value dupe
+
+    SECTION("Uniform latency is bounded and deterministic for a seed") {
+        fseamMock->dupeLatency<FSeam::DependencyGettable::checkCalled>(FSeam::Latency::Uniform(1ms, 3ms, 1337));
+        std::vector<FSeam::VirtualClock::duration> delays;
+        for (int i = 0; i < 50; ++i) {
+            auto before = FSeam::VirtualClock::elapsed();
+            testingClass.getDepGettable().checkCalled();
+            delays.emplace_back(FSeam::VirtualClock::elapsed() - before);
+        }
+        FSeam::Latency::Uniform replay(1ms, 3ms, 1337);
+        for (auto delay : delays) {
+            CHECK(delay >= 1ms);
+            CHECK(delay <= 3ms);
+            CHECK(delay == replay.next());
+        }
+
+    } // End section : Uniform latency is bounded and deterministic for a seed
+
+    SECTION("Histogram latency only returns recorded delays") {
+        fseamMock->dupeLatency<FSeam::DependencyGettable::checkCalled>(FSeam::Latency::Histogram({{1ms, 9.}, {100ms, 1.}}));
+        for (int i = 0; i < 20; ++i) {
+            auto before = FSeam::VirtualClock::elapsed();
+            testingClass.getDepGettable().checkCalled();
+            auto delay = FSeam::VirtualClock::elapsed() - before;
+            CHECK((delay == 1ms || delay == 100ms));
+        }
+
+    } // End section : Histogram latency only returns recorded delays
+
+    SECTION("Rate limit blocks on the virtual clock when exhausted") {
+        fseamMock->dupeRateLimit<FSeam::DependencyGettable::checkCalled>(FSeam::Latency::TokenBucket(2, 1s));
+
+        testingClass.getDepGettable().checkCalled();
+        testingClass.getDepGettable().checkCalled();
+        CHECK(0s == FSeam::VirtualClock::elapsed());
+        testingClass.getDepGettable().checkCalled();
+        CHECK(1s == FSeam::VirtualClock::elapsed());
+        testingClass.getDepGettable().checkCalled();
+        CHECK(2s == FSeam::VirtualClock::elapsed());
+
+    } // End section : Rate limit blocks on the virtual clock when exhausted
+
+    SECTION("Rate limit fails when exhausted") {
+        fseamMock->dupeReturn<FSeam::DependencyGettable::checkSimpleReturnValue>(1);
+        fseamMock->dupeRateLimit<FSeam::DependencyGettable::checkSimpleReturnValue>(FSeam::Latency::TokenBucket(1, 10ms),
+                [](void *methodCallData) {
+                    static_cast<FSeam::DependencyGettableData *>(methodCallData)->checkSimpleReturnValue_ReturnValue = -1;
+                });
+
+        CHECK(1 == testingClass.getDepGettable().checkSimpleReturnValue());
+        CHECK(-1 == testingClass.getDepGettable().checkSimpleReturnValue());
+        FSeam::VirtualClock::advance(10ms);
+        CHECK(1 == testingClass.getDepGettable().checkSimpleReturnValue());
+        CHECK(10ms == FSeam::VirtualClock::elapsed());
+
+    } // End section : Rate limit fails when exhausted
+
+    FSeam::MockVerifier::cleanUp();
+    REQUIRE(0s == FSeam::VirtualClock::elapsed());
+
+} // End Test_Case : FSeamLatencyTest
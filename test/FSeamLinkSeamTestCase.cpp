@@ -0,0 +1,44 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <Checksum.hh>
+#include <ChecksumValidator.hh>
+#include <FSeamMockData.hpp>
+
+// ChecksumValidator is not recompiled for this test: it is linked from the weakened copy of testLib,
+// its call to Checksum::compute is resolved to the generated mock at link time.
+TEST_CASE("FSeamLinkSeamTest") {
+    source::ChecksumValidator validator {};
+    auto fseamMock = FSeam::getDefault<source::Checksum>();
+
+    SECTION("Mock override the production implementation") {
+        fseamMock->dupeReturn<FSeam::Checksum::compute>(42);
+        REQUIRE(validator.isValid("FSeam", 42));
+        REQUIRE_FALSE(validator.isValid("FSeam", 1337));
+        REQUIRE(fseamMock->verify(FSeam::Checksum::compute::NAME, 2));
+
+    } // End section : Mock override the production implementation
+
+    SECTION("Argument expectation") {
+        fseamMock->expectArg<FSeam::Checksum::compute>(FSeam::CustomComparator<const std::string &>([](const auto &content) {
+            return content == "FyS";
+        }), FSeam::VerifyCompare{1});
+        validator.isValid("FyS", 0);
+        validator.isValid("FSeam", 0);
+        REQUIRE(fseamMock->verify(FSeam::Checksum::compute::NAME, 2));
+
+    } // End section : Argument expectation
+
+    SECTION("Not selected methods keep their real implementation") {
+        source::Checksum checksum {};
+        fseamMock->dupeReturn<FSeam::Checksum::compute>(42);
+        REQUIRE(42 == checksum.compute("FSeam"));
+        REQUIRE(2 == checksum.blockCount("FSeam", 4));
+        REQUIRE(fseamMock->verify(FSeam::Checksum::blockCount::NAME, FSeam::NeverCalled{}));
+
+    } // End section : Not selected methods keep their real implementation
+
+    FSeam::MockVerifier::cleanUp();
+} // End Test_Case : FSeamLinkSeamTest
@@ -0,0 +1,30 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <Checksum.hh>
+#include <ChecksumValidator.hh>
+#include <FSeamMockData.hpp>
+
+// The test is linked against the real testSharedLib, the mock of Checksum::compute is built into testFSeamPreloadMocks
+// and interposed at load time (LD_PRELOAD set by ctest)
+TEST_CASE("FSeamPreloadTest") {
+    source::ChecksumValidator validator {};
+    auto fseamMock = FSeam::getDefault<source::Checksum>();
+
+    SECTION("Preloaded mock interpose the shared library implementation") {
+        fseamMock->dupeReturn<FSeam::Checksum::compute>(42);
+        REQUIRE(validator.isValid("FSeam", 42));
+        REQUIRE(42 == source::Checksum{}.compute("FyS"));
+        REQUIRE(fseamMock->verify(FSeam::Checksum::compute::NAME, 2));
+
+    } // End section : Preloaded mock interpose the shared library implementation
+
+    SECTION("Not selected methods keep their real implementation") {
+        REQUIRE(2 == source::Checksum{}.blockCount("FSeam", 4));
+
+    } // End section : Not selected methods keep their real implementation
+
+    FSeam::MockVerifier::cleanUp();
+} // End Test_Case : FSeamPreloadTest
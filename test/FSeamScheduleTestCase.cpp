@@ -0,0 +1,131 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <TestingClass.hh>
+#include <FSeamMockData.hpp>
+#include <FSeamSchedule.hpp>
+
+namespace {
+
+    /**
+     * @brief non atomic increment, a mocked call (schedule point) between the load and the store
+     */
+    bool lostUpdate(FSeam::Schedule::Run &run, source::DependencyGettable &dependency) {
+        int counter = 0;
+        for (int i = 0; i < 2; ++i) {
+            run.spawn([&counter, &dependency]() {
+                int value = counter;
+                dependency.checkCalled();
+                counter = value + 1;
+            });
+        }
+        run.join();
+        return counter == 2;
+    }
+
+}
+
+TEST_CASE("FSeamScheduleTest") {
+    source::TestingClass testingClass {};
+    auto &dependency = testingClass.getDepGettable();
+    auto fseamMock = FSeam::get(&dependency);
+
+    SECTION("PCT finds the lost update and the failing schedule is replayed") {
+        FSeam::Schedule::Options options;
+        options.seed = 42;
+        auto result = FSeam::Schedule::explore(options, [&dependency](FSeam::Schedule::Run &run) {
+            return lostUpdate(run, dependency);
+        });
+        REQUIRE(result.failed);
+        CHECK_FALSE(result.schedule.empty());
+
+        for (int i = 0; i < 10; ++i) {
+            FSeam::Schedule::Options replay;
+            replay.replay = result.schedule;
+            auto replayed = FSeam::Schedule::explore(replay, [&dependency](FSeam::Schedule::Run &run) {
+                return lostUpdate(run, dependency);
+            });
+            CHECK(1 == replayed.runs);
+            CHECK(replayed.failed);
+            CHECK(result.schedule == replayed.schedule);
+        }
+
+        // same failing run from its seed
+        FSeam::Schedule::Options seeded;
+        seeded.seed = result.seed;
+        seeded.steps = result.steps;
+        seeded.runs = 1;
+        CHECK(FSeam::Schedule::explore(seeded, [&dependency](FSeam::Schedule::Run &run) {
+            return lostUpdate(run, dependency);
+        }).failed);
+
+    } // End section : PCT finds the lost update and the failing schedule is replayed
+
+    SECTION("Exhaustive exploration within the preemption bound") {
+        FSeam::Schedule::Options options;
+        options.strategy = FSeam::Schedule::Strategy::Exhaustive;
+        options.preemptions = 1;
+
+        auto result = FSeam::Schedule::explore(options, [&dependency](FSeam::Schedule::Run &run) {
+            return lostUpdate(run, dependency);
+        });
+        CHECK(result.failed);
+
+        // the atomic increment passes on all the schedules
+        fseamMock->reset();
+        options.stopOnFailure = false;
+        std::size_t interleavings = 0;
+        result = FSeam::Schedule::explore(options, [&dependency, &interleavings](FSeam::Schedule::Run &run) {
+            std::atomic<int> counter = 0;
+            for (int i = 0; i < 2; ++i) {
+                run.spawn([&counter, &dependency]() {
+                    dependency.checkCalled();
+                    counter.fetch_add(1);
+                    dependency.checkCalled();
+                });
+            }
+            run.join();
+            ++interleavings;
+            return counter == 2;
+        });
+        CHECK_FALSE(result.failed);
+        CHECK(result.exhausted);
+        CHECK(interleavings == result.runs);
+        CHECK(1 < result.runs);
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, static_cast<int>(4 * result.runs)));
+
+    } // End section : Exhaustive exploration within the preemption bound
+
+    SECTION("The schedule point is released when the body throws") {
+        FSeam::Schedule::Options options;
+        CHECK_THROWS_AS(FSeam::Schedule::explore(options, [](FSeam::Schedule::Run &) -> bool {
+            throw std::runtime_error("failure of the body");
+        }), std::runtime_error);
+        CHECK(nullptr == FSeam::SchedulePoint::hook.load());
+
+    } // End section : The schedule point is released when the body throws
+
+    SECTION("Thousands of schedules explored") {
+        FSeam::Schedule::Options options;
+        options.runs = 2000;
+        options.stopOnFailure = false;
+        auto start = std::chrono::steady_clock::now();
+        auto result = FSeam::Schedule::explore(options, [&dependency](FSeam::Schedule::Run &run) {
+            lostUpdate(run, dependency);
+            return true;
+        });
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        // the throughput depends on the machine, it is only reported (run with -s)
+        INFO("2000 schedules explored in " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms");
+        CHECK(2000 == result.runs);
+
+    } // End section : Thousands of schedules explored
+
+    FSeam::MockVerifier::cleanUp();
+}
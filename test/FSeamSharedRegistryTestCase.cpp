@@ -0,0 +1,140 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <set>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <TestingClass.hh>
+#include <FSeamMockData.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    /**
+     * @brief run the given function in a forked process, exit code is the returned value (0 on success)
+     */
+    template <typename Function>
+    pid_t forkWith(Function &&function) {
+        pid_t pid = fork();
+        if (pid == 0)
+            _exit(function());
+        return pid;
+    }
+
+    bool succeeded(pid_t pid) {
+        int status = 0;
+        return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && !WEXITSTATUS(status);
+    }
+
+}
+
+TEST_CASE("FSeamSharedRegistryTest") {
+    source::TestingClass testingClass {};
+    auto &dependency = testingClass.getDepGettable();
+    auto fseamMock = FSeam::get(&dependency);
+    REQUIRE(FSeam::MockVerifier::shareAcrossProcesses());
+
+    SECTION("Calls made in forked processes are verified in the parent") {
+        fseamMock->dupeReturn<FSeam::DependencyGettable::checkSimpleReturnValue>(42);
+        dependency.checkSimpleReturnValue();
+
+        // the dupe is inherited through fork
+        pid_t child = forkWith([&dependency]() {
+            return dependency.checkSimpleReturnValue() == 42 && dependency.checkSimpleReturnValue() == 42 ? 0 : 1;
+        });
+        REQUIRE(succeeded(child));
+
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkSimpleReturnValue::NAME, 3));
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, FSeam::NeverCalled{}));
+
+        auto calls = fseamMock->sharedCalls(FSeam::DependencyGettable::checkSimpleReturnValue::NAME);
+        REQUIRE(3 == calls.size());
+        CHECK(getpid() == calls[0].pid);
+        CHECK(child == calls[1].pid);
+        CHECK(child == calls[2].pid);
+        CHECK(calls[1].sequence < calls[2].sequence);
+
+    } // End section : Calls made in forked processes are verified in the parent
+
+    SECTION("Method only called in the forked processes") {
+        constexpr int CHILDREN = 4;
+        constexpr int CALLS = 1000;
+        std::vector<pid_t> children;
+
+        for (int i = 0; i < CHILDREN; ++i) {
+            children.emplace_back(forkWith([&dependency]() {
+                for (int call = 0; call < CALLS; ++call)
+                    dependency.checkCalled();
+                return 0;
+            }));
+        }
+        for (pid_t child : children)
+            REQUIRE(succeeded(child));
+
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, CHILDREN * CALLS));
+        auto calls = fseamMock->sharedCalls(FSeam::DependencyGettable::checkCalled::NAME);
+        CHECK(CHILDREN * CALLS == calls.size());
+        std::set<std::int64_t> pids;
+        for (const auto &call : calls)
+            pids.insert(call.pid);
+        CHECK(CHILDREN == pids.size());
+
+    } // End section : Method only called in the forked processes
+
+    SECTION("Default mocks created in the forked process") {
+        pid_t child = forkWith([]() {
+            source::DependencyGettable other;
+            other.checkCalled();
+            return 0;
+        });
+        REQUIRE(succeeded(child));
+
+        CHECK(FSeam::getDefault<source::DependencyGettable>()->verify(FSeam::DependencyGettable::checkCalled::NAME, 1));
+
+    } // End section : Default mocks created in the forked process
+
+    SECTION("Reset clears the shared counters and records") {
+        dependency.checkCalled();
+        REQUIRE(succeeded(forkWith([&dependency]() { dependency.checkCalled(); return 0; })));
+        REQUIRE(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, 2));
+
+        FSeam::MockVerifier::reset();
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, FSeam::NeverCalled{}));
+        CHECK(fseamMock->sharedCalls(FSeam::DependencyGettable::checkCalled::NAME).empty());
+
+    } // End section : Reset clears the shared counters and records
+
+    SECTION("Calls made before the registry is shared are counted") {
+        dependency.checkCalled();
+        dependency.checkCalled();
+        REQUIRE(FSeam::MockVerifier::shareAcrossProcesses());
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, 2));
+
+        // inserted by the child, the inherited calls are not counted twice by the parent
+        REQUIRE(succeeded(forkWith([&dependency]() { dependency.checkCalled(); return 0; })));
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, 3));
+        dependency.checkCalled();
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, 4));
+
+    } // End section : Calls made before the registry is shared are counted
+
+    SECTION("Verify fails on the methods not counted by a full registry") {
+        REQUIRE(FSeam::MockVerifier::shareAcrossProcesses(1));
+        REQUIRE(succeeded(forkWith([&dependency]() {
+            dependency.checkCalled();
+            dependency.checkSimpleInputVariable(1, "a");
+            return 0;
+        })));
+
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkCalled::NAME, 1));
+        CHECK_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, 1, false));
+        CHECK_FALSE(fseamMock->verify(FSeam::DependencyGettable::checkSimpleInputVariable::NAME, FSeam::NeverCalled{}, false));
+
+    } // End section : Verify fails on the methods not counted by a full registry
+
+    FSeam::MockVerifier::cleanUp();
+}
@@ -0,0 +1,139 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <TestingClass.hh>
+#include <FSeamMockData.hpp>
+#include <FSeamTrace.hpp>
+
+TEST_CASE("FSeamRecordReplayTest") {
+    const std::string tracePath = "FSeamRecordReplayTest.trace";
+    source::TestingClass testingClass {};
+
+    {
+        auto fseamMock = FSeam::get(&testingClass.getDepGettable());
+        FSeam::Trace::Recorder recorder(tracePath);
+        // stub implementation
+        fseamMock->dupeReturnSequence<FSeam::DependencyGettable::checkSimpleReturnValue>({1, 2, 3});
+        recorder.record<FSeam::DependencyGettable::checkSimpleReturnValue>(fseamMock);
+        recorder.record<FSeam::DependencyGettable::checkSimpleInputVariable>(fseamMock);
+
+        testingClass.getDepGettable().checkSimpleInputVariable(42, "FyS");
+        CHECK(1 == testingClass.getDepGettable().checkSimpleReturnValue());
+        testingClass.getDepGettable().checkSimpleInputVariable(1337, "FSeam");
+        CHECK(2 == testingClass.getDepGettable().checkSimpleReturnValue());
+        CHECK(3 == testingClass.getDepGettable().checkSimpleReturnValue());
+        recorder.close();
+        FSeam::MockVerifier::cleanUp();
+    }
+    auto fseamMock = FSeam::get(&testingClass.getDepGettable());
+    FSeam::Trace::Replayer replayer(tracePath);
+    REQUIRE(replayer.isValid());
+    replayer.replay<FSeam::DependencyGettable::checkSimpleReturnValue>(fseamMock);
+    replayer.replay<FSeam::DependencyGettable::checkSimpleInputVariable>(fseamMock);
+
+    SECTION("Replay return values and cross-check arguments") {
+        testingClass.getDepGettable().checkSimpleInputVariable(42, "FyS");
+        CHECK(1 == testingClass.getDepGettable().checkSimpleReturnValue());
+        testingClass.getDepGettable().checkSimpleInputVariable(1337, "FSeam");
+        CHECK(2 == testingClass.getDepGettable().checkSimpleReturnValue());
+        CHECK(3 == testingClass.getDepGettable().checkSimpleReturnValue());
+        CHECK(0 == replayer.mismatches());
+        CHECK(replayer.verify());
+        CHECK(fseamMock->verify(FSeam::DependencyGettable::checkSimpleReturnValue::NAME, 3));
+
+    } // End section : Replay return values and cross-check arguments
+
+    SECTION("Arguments mismatch") {
+        testingClass.getDepGettable().checkSimpleInputVariable(42, "FyS");
+        testingClass.getDepGettable().checkSimpleInputVariable(1337, "NotFSeam");
+        CHECK(1 == replayer.mismatches());
+        CHECK_FALSE(replayer.verify(false, false));
+
+    } // End section : Arguments mismatch
+
+    SECTION("Incomplete replay") {
+        testingClass.getDepGettable().checkSimpleInputVariable(42, "FyS");
+        CHECK(replayer.verify(false));
+        CHECK_FALSE(replayer.verify(true, false));
+
+    } // End section : Incomplete replay
+
+    SECTION("Call after the end of the recording") {
+        for (int i = 0; i < 3; ++i)
+            testingClass.getDepGettable().checkSimpleReturnValue();
+        CHECK(replayer.verify(false));
+        testingClass.getDepGettable().checkSimpleReturnValue();
+        CHECK_FALSE(replayer.verify(false, false));
+
+    } // End section : Call after the end of the recording
+
+    FSeam::MockVerifier::cleanUp();
+    std::remove(tracePath.c_str());
+} // End Test_Case : FSeamRecordReplayTest
+
+TEST_CASE("FSeamCallHistoryTest") {
+    const std::string tracePath = "FSeamCallHistoryTest.trace";
+    source::TestingClass testingClass {};
+    auto fseamMock = FSeam::get(&testingClass.getDepGettable());
+    FSeam::Trace::Recorder recorder(tracePath);
+    recorder.record<FSeam::DependencyGettable::checkCalled>(fseamMock);
+    recorder.record<FSeam::DependencyGettable::checkSimpleInputVariable>(fseamMock);
+    recorder.record<FSeam::DependencyGettable::checkSimpleReturnValue>(fseamMock);
+
+    testingClass.getDepGettable().checkSimpleInputVariable(42, "FyS");
+    for (int i = 0; i < 1000; ++i) {
+        FSeam::VirtualClock::advance(std::chrono::milliseconds(1));
+        testingClass.getDepGettable().checkCalled();
+        testingClass.getDepGettable().checkSimpleInputVariable(i, "FSeam");
+    }
+    recorder.close();
+
+    FSeam::Trace::CallHistory history(tracePath);
+    REQUIRE(history.isValid());
+
+    SECTION("Count recorded calls") {
+        CHECK(1000 == history.count<FSeam::DependencyGettable::checkCalled>());
+        CHECK(1001 == history.count<FSeam::DependencyGettable::checkSimpleInputVariable>());
+        CHECK(0 == history.count<FSeam::DependencyGettable::checkSimpleReturnValue>());
+        CHECK(500 == history.countIf<FSeam::DependencyGettable::checkSimpleInputVariable>([](const auto &args) {
+            return *std::get<0>(args) % 2 == 0 && *std::get<1>(args) == "FSeam";
+        }));
+
+    } // End section : Count recorded calls
+
+    SECTION("Verify recorded calls") {
+        CHECK(history.verify<FSeam::DependencyGettable::checkCalled>(1000));
+        CHECK(history.verify<FSeam::DependencyGettable::checkCalled>(FSeam::AtLeast{999}));
+        CHECK(history.verify<FSeam::DependencyGettable::checkSimpleReturnValue>(FSeam::NeverCalled{}));
+        CHECK_FALSE(history.verify<FSeam::DependencyGettable::checkCalled>(FSeam::AtMost{10}, false));
+
+    } // End section : Verify recorded calls
+
+    SECTION("Verify recorded arguments") {
+        CHECK(history.verifyArg<FSeam::DependencyGettable::checkSimpleInputVariable>(FSeam::Eq(42), FSeam::Eq(std::string("FyS"))));
+        CHECK(history.verifyArg<FSeam::DependencyGettable::checkSimpleInputVariable>(FSeam::Eq(42), FSeam::Any(), 2));
+        CHECK(history.verifyArg<FSeam::DependencyGettable::checkSimpleInputVariable>(FSeam::Any(), FSeam::Eq(std::string("FSeam")), 1000));
+        CHECK(history.verifyArg<FSeam::DependencyGettable::checkSimpleInputVariable>(FSeam::Eq(1337), FSeam::Any(), FSeam::NeverCalled{}));
+
+    } // End section : Verify recorded arguments
+
+    SECTION("Order and timestamp of the recorded calls") {
+        CHECK(history.calledBefore<FSeam::DependencyGettable::checkSimpleInputVariable, FSeam::DependencyGettable::checkCalled>());
+        CHECK_FALSE(history.calledBefore<FSeam::DependencyGettable::checkCalled, FSeam::DependencyGettable::checkSimpleInputVariable>());
+        CHECK_FALSE(history.calledBefore<FSeam::DependencyGettable::checkCalled, FSeam::DependencyGettable::checkSimpleReturnValue>());
+
+        FSeam::VirtualClock::duration last {};
+        history.forEachCall<FSeam::DependencyGettable::checkCalled>([&last](const auto &, FSeam::VirtualClock::duration timestamp) {
+            last = timestamp;
+            return true;
+        });
+        CHECK(std::chrono::seconds(1) == last);
+
+    } // End section : Order and timestamp of the recorded calls
+
+    FSeam::MockVerifier::cleanUp();
+    std::remove(tracePath.c_str());
+} // End Test_Case : FSeamCallHistoryTest
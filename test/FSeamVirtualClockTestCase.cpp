@@ -0,0 +1,60 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <FSeamMockData.hpp>
+#include <FSeamLatency.hpp>
+#include <Clock.hh>
+#include <Poller.hh>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Test virtual clock seam") {
+    auto mockFreeFunc = FSeam::getFreeFunc();
+    mockFreeFunc->dupeVirtualClock<FSeam::FreeFunction::steadyNow>();
+    mockFreeFunc->dupeVirtualClock<FSeam::FreeFunction::epochMillis, std::chrono::milliseconds>();
+    mockFreeFunc->dupeVirtualSleep<FSeam::FreeFunction::sleepFor>();
+
+    SECTION("Mocked time follows the virtual clock") {
+        auto begin = source::steadyNow();
+        CHECK(0 == source::epochMillis());
+        FSeam::VirtualClock::advance(1500ms);
+        CHECK(1500ms == source::steadyNow() - begin);
+        CHECK(1500 == source::epochMillis());
+        source::sleepFor(500ms);
+        CHECK(2s == source::steadyNow() - begin);
+        CHECK(mockFreeFunc->verify(FSeam::FreeFunction::sleepFor::NAME, 1));
+
+    } // End section : Mocked time follows the virtual clock
+
+    SECTION("Origin of the virtual clock") {
+        FSeam::VirtualClock::setOrigin(1h);
+        CHECK(3600000 == source::epochMillis());
+        CHECK(1h == FSeam::VirtualClock::now().time_since_epoch());
+        CHECK(0s == FSeam::VirtualClock::elapsed());
+
+    } // End section : Origin of the virtual clock
+
+    SECTION("Timeout path runs instantly") {
+        source::Poller poller;
+
+        CHECK_FALSE(poller.waitReady([]() { return false; }, 30s, 100ms));
+        CHECK(300 == poller.getPollCount());
+        CHECK(30s == FSeam::VirtualClock::elapsed());
+
+    } // End section : Timeout path runs instantly
+
+    SECTION("Latency dupes are seen by the tested code") {
+        source::Poller poller;
+        int tries = 0;
+        mockFreeFunc->dupeLatency<FSeam::FreeFunction::sleepFor>(FSeam::Latency::Fixed(900ms));
+
+        CHECK(poller.waitReady([&tries]() { return ++tries == 3; }, 5s, 100ms));
+        CHECK(2s == FSeam::VirtualClock::elapsed());
+
+    } // End section : Latency dupes are seen by the tested code
+
+    FSeam::MockVerifier::cleanUp();
+} // End TestCase : Test virtual clock seam
@@ -0,0 +1,129 @@
+#! /usr/bin/env python
+#
+# Created by FyS on 10/19/26.
+#
+"""
+Test of the watch mode of the FSeam generator: generation requests served by the daemon, and re-generation of the
+mock when its header is saved.
+"""
+
+import contextlib
+import io
+import json
+import os
+import socket
+import sys
+import tempfile
+import threading
+import time
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Generator"))
+
+import FSeamWatch
+
+HEADER_CONTENT = "#pragma once\nnamespace source {\nclass Watched {\npublic:\n    int first(int value);\n%s};\n}\n"
+
+
+def writeHeader(path, extraMethods=""):
+    with open(path, "w") as header:
+        header.write(HEADER_CONTENT % extraMethods)
+
+
+def waitFor(predicate, timeout=5.0):
+    _end = time.monotonic() + timeout
+    while time.monotonic() < _end:
+        if predicate():
+            return True
+        time.sleep(0.01)
+    return False
+
+
+def generatedContent(folder):
+    _path = os.path.join(folder, "Watched.fseam.cc")
+    if not os.path.exists(_path):
+        return ""
+    with open(_path, "r") as generated:
+        return generated.read()
+
+
+class FSeamWatchTest(unittest.TestCase):
+
+    def setUp(self):
+        self.folder = tempfile.TemporaryDirectory()
+        self.header = os.path.join(self.folder.name, "Watched.hh")
+        self.socket = os.path.join(self.folder.name, "fseam.sock")
+        writeHeader(self.header)
+        self.daemon = FSeamWatch.WatchDaemon(self.socket, log=None)
+        self.thread = threading.Thread(target=self.daemon.serveForever)
+        self.thread.start()
+
+    def tearDown(self):
+        self.daemon.stop()
+        self.thread.join()
+        self.folder.cleanup()
+
+    def argv(self):
+        return [self.header, self.folder.name]
+
+    def request(self):
+        with contextlib.redirect_stdout(io.StringIO()) as output:
+            _status = FSeamWatch.request(self.socket, self.argv())
+        return _status, output.getvalue()
+
+    def isGenerationRecorded(self):
+        """
+        :return: True if the daemon recorded the generation of the current content of the header (the mock is written
+                 before the generation is recorded)
+        """
+        _generation = self.daemon.generations.get(FSeamWatch.WatchDaemon._key(self.argv()))
+        return _generation is not None and _generation["stamps"] == FSeamWatch.WatchDaemon._stamps(self.argv())
+
+    def test_request_generates_then_reports_fresh(self):
+        _status, _output = self.request()
+        self.assertEqual(0, _status)
+        self.assertIn("source::Watched::first", generatedContent(self.folder.name))
+        _status, _output = self.request()
+        self.assertEqual(0, _status)
+        self.assertIn("already generated", _output)
+
+    def test_saved_header_is_regenerated(self):
+        self.assertEqual(0, self.request()[0])
+        if self.daemon.inotify is None:
+            self.skipTest("inotify unavailable")
+        writeHeader(self.header, "    int second(int value);\n")
+        self.assertTrue(waitFor(self.isGenerationRecorded))
+        self.assertIn("source::Watched::second", generatedContent(self.folder.name))
+        # the build then finds the mock up to date
+        self.assertIn("already generated", self.request()[1])
+
+    def rawRequest(self, line, readAnswer=True):
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+            client.connect(self.socket)
+            client.sendall(line)
+            if not readAnswer:
+                return None
+            with client.makefile("r") as stream:
+                return stream.readline()
+
+    def test_malformed_request_is_answered_and_daemon_keeps_serving(self):
+        _answer = json.loads(self.rawRequest(b"not json\n"))
+        self.assertEqual(1, _answer["status"])
+        self.assertIn("invalid request", _answer["output"])
+        self.assertEqual(1, json.loads(self.rawRequest(b'{"argv": []}\n'))["status"])
+        self.assertEqual(0, self.request()[0])
+
+    def test_client_gone_before_the_answer(self):
+        # the client disconnects without reading the answer (interrupted make)
+        for _ in range(5):
+            self.rawRequest(json.dumps({"argv": self.argv(), "cwd": os.getcwd()}).encode() + b"\n",
+                            readAnswer=False)
+        self.assertTrue(self.thread.is_alive())
+        self.assertEqual(0, self.request()[0])
+
+    def test_no_daemon_listening(self):
+        self.assertIsNone(FSeamWatch.request(os.path.join(self.folder.name, "none.sock"), self.argv()))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -21,6 +21,11 @@ namespace source {
         short testShort;
         std::string testStr;
     };
+
+    struct LargeMessageTest {
+        int id;
+        char payload[1024];
+    };
 }
 
 #endif //FSEAM_ARGSSTRUCT_HH
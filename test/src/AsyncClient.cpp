@@ -0,0 +1,23 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include "AsyncClient.hh"
+
+void source::AsyncClient::request(const std::vector<int> &keys) {
+    for (int key : keys)
+        _inFlight.emplace_back(_store.fetch(key));
+}
+
+std::size_t source::AsyncClient::poll() {
+    auto received = std::stable_partition(_inFlight.begin(), _inFlight.end(), [](const std::future<std::string> &response) {
+        return response.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    });
+    std::size_t count = static_cast<std::size_t>(_inFlight.end() - received);
+    for (auto it = received; it != _inFlight.end(); ++it)
+        _responses.emplace_back(it->get());
+    _inFlight.erase(received, _inFlight.end());
+    return count;
+}
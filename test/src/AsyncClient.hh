@@ -0,0 +1,40 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#ifndef FSEAM_ASYNCCLIENT_HH
+#define FSEAM_ASYNCCLIENT_HH
+
+#include <future>
+#include <string>
+#include <vector>
+#include "RemoteStore.hh"
+
+namespace source {
+
+    /**
+     * @brief pipelined client : the requests are sent without waiting for the responses of the previous ones
+     */
+    class AsyncClient {
+    public:
+        void request(const std::vector<int> &keys);
+
+        /**
+         * @brief collect the responses received (without blocking)
+         * @return number of responses collected
+         */
+        std::size_t poll();
+
+        std::size_t getInFlight() const { return _inFlight.size(); }
+        const std::vector<std::string> &getResponses() const { return _responses; }
+        RemoteStore &getStore() { return _store; }
+
+    private:
+        RemoteStore _store;
+        std::vector<std::future<std::string>> _inFlight;
+        std::vector<std::string> _responses;
+    };
+
+}
+
+#endif //FSEAM_ASYNCCLIENT_HH
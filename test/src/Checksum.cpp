@@ -0,0 +1,16 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include "Checksum.hh"
+
+int source::Checksum::compute(const std::string &content) {
+    int checksum = 0;
+    for (char c : content)
+        checksum = checksum * 31 + c;
+    return checksum;
+}
+
+std::size_t source::Checksum::blockCount(const std::string &content, std::size_t blockSize) {
+    return (content.size() + blockSize - 1) / blockSize;
+}
@@ -0,0 +1,21 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#ifndef FSEAM_CHECKSUM_HH
+#define FSEAM_CHECKSUM_HH
+
+#include <string>
+
+namespace source {
+
+    class Checksum {
+    public:
+        int compute(const std::string &content);
+
+        std::size_t blockCount(const std::string &content, std::size_t blockSize);
+    };
+
+}
+
+#endif //FSEAM_CHECKSUM_HH
@@ -0,0 +1,11 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include "Checksum.hh"
+#include "ChecksumValidator.hh"
+
+bool source::ChecksumValidator::isValid(const std::string &content, int expectedChecksum) {
+    source::Checksum checksum;
+    return checksum.compute(content) == expectedChecksum;
+}
@@ -0,0 +1,22 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#ifndef FSEAM_CHECKSUMVALIDATOR_HH
+#define FSEAM_CHECKSUMVALIDATOR_HH
+
+#include <string>
+
+namespace source {
+
+    /**
+     * Production code using source::Checksum, compiled once into the testLib library (used to test the link seam mode)
+     */
+    class ChecksumValidator {
+    public:
+        bool isValid(const std::string &content, int expectedChecksum);
+    };
+
+}
+
+#endif //FSEAM_CHECKSUMVALIDATOR_HH
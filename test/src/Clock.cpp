@@ -0,0 +1,18 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <thread>
+#include "Clock.hh"
+
+std::chrono::steady_clock::time_point source::steadyNow() {
+    return std::chrono::steady_clock::now();
+}
+
+std::int64_t source::epochMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void source::sleepFor(std::chrono::milliseconds duration) {
+    std::this_thread::sleep_for(duration);
+}
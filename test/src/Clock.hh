@@ -0,0 +1,25 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#ifndef FSEAM_CLOCK_HH
+#define FSEAM_CLOCK_HH
+
+#include <chrono>
+#include <cstdint>
+
+namespace source {
+
+    /**
+     * Wrapper on std::chrono used by the tested code in order to read the time / sleep
+     * (mocked with the FSeam::VirtualClock in the tests)
+     */
+    std::chrono::steady_clock::time_point steadyNow();
+
+    std::int64_t epochMillis();
+
+    void sleepFor(std::chrono::milliseconds duration);
+
+}
+
+#endif //FSEAM_CLOCK_HH
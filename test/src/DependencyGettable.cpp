@@ -47,3 +47,13 @@ void source::DependencyGettable::checkCustomStructInputVariable(source::StructTe
     std::cout << "Original " << __func__ << " called with " << testStr.testInt << " " << testStr.testShort << " " << testStr.testStr << " \n";
     _hasOriginalBeenCalled = true;
 }
+
+void source::DependencyGettable::checkMoveOnlyInputVariable(std::unique_ptr<source::StructTest> buffer) {
+    std::cout << "Original " << __func__ << " called\n";
+    _hasOriginalBeenCalled = true;
+}
+
+void source::DependencyGettable::checkLargeMessageInputVariable(source::LargeMessageTest message) {
+    std::cout << "Original " << __func__ << " called with " << message.id << " \n";
+    _hasOriginalBeenCalled = true;
+}
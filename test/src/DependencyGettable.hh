@@ -6,6 +6,7 @@
 #define PROJECT_DEPEDENCYGETTABLE_HH
 
 #include <string>
+#include <memory>
 #include <ArgsStruct.hh>
 
 namespace source {
@@ -31,6 +32,10 @@ namespace source {
         source::StructTest &checkCustomStructReturnValueRef();
         void checkCustomStructInputVariableRef(const source::StructTest &testStr);
 
+        // move-only argument / large trivially copyable argument by value
+        void checkMoveOnlyInputVariable(std::unique_ptr<source::StructTest> buffer);
+        void checkLargeMessageInputVariable(source::LargeMessageTest message);
+
 
         /**
          * @brief check if this class has been used into its original form or not
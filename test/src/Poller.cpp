@@ -0,0 +1,18 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include <Clock.hh>
+#include "Poller.hh"
+
+bool source::Poller::waitReady(const std::function<bool()> &isReady, std::chrono::milliseconds timeout, std::chrono::milliseconds pollPeriod) {
+    auto deadline = source::steadyNow() + timeout;
+
+    while (source::steadyNow() < deadline) {
+        ++_pollCount;
+        if (isReady())
+            return true;
+        source::sleepFor(pollPeriod);
+    }
+    return false;
+}
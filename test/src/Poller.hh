@@ -0,0 +1,29 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#ifndef FSEAM_POLLER_HH
+#define FSEAM_POLLER_HH
+
+#include <chrono>
+#include <functional>
+
+namespace source {
+
+    class Poller {
+    public:
+        /**
+         * @brief poll the readiness predicate every pollPeriod until it returns true or the timeout is reached
+         * @return true if ready before the timeout, false otherwise
+         */
+        bool waitReady(const std::function<bool()> &isReady, std::chrono::milliseconds timeout, std::chrono::milliseconds pollPeriod);
+
+        std::size_t getPollCount() const { return _pollCount; }
+
+    private:
+        std::size_t _pollCount = 0;
+    };
+
+}
+
+#endif //FSEAM_POLLER_HH
@@ -0,0 +1,9 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#include "RemoteStore.hh"
+
+std::future<std::string> source::RemoteStore::fetch(int key) {
+    return std::async(std::launch::async, [key]() { return "remote" + std::to_string(key); });
+}
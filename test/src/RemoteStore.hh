@@ -0,0 +1,23 @@
+//
+// Created by FyS on 10/19/26.
+//
+
+#ifndef FSEAM_REMOTESTORE_HH
+#define FSEAM_REMOTESTORE_HH
+
+#include <future>
+#include <string>
+
+namespace source {
+
+    class RemoteStore {
+    public:
+        /**
+         * @brief asynchronous fetch of the value of the given key
+         */
+        std::future<std::string> fetch(int key);
+    };
+
+}
+
+#endif //FSEAM_REMOTESTORE_HH